@@ -853,20 +853,23 @@ namespace ngbla
 
 
 
-  inline void LapackInverseSPD (ngbla::SliceMatrix<double> a)
+  // returns false if the matrix is not positive definite, a is then overwritten
+  inline bool LapackInverseSPD (ngbla::SliceMatrix<double> a)
   {
     integer n = a.Width();
-    if (n == 0) return;
+    if (n == 0) return true;
     integer lda = max(size_t(1), a.Dist());
 
     integer info;
     char uplo = 'U';
 
     dpotrf_ (&uplo, &n, &a(0,0), &lda, &info);
+    if (info != 0) return false;
     dpotri_ (&uplo, &n, &a(0,0), &lda, &info);
     for (int i = 0; i < n; i++)
       for (int j = 0; j < i; j++)
 	a(j,i) = a(i,j);
+    return info == 0;
   }
 
 
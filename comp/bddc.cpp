@@ -6,6 +6,28 @@
 namespace ngcomp
 {
 
+  /*
+    Inverse of the element inner block.  For spd problems the 
+    Cholesky-based inverse needs half the flops of the LU-based one,
+    if the factorization fails we fall back to the general inverse.
+   */
+  template <typename SCAL>
+  void CalcInnerInverse (FlatMatrix<SCAL> d, bool spd, LocalHeap & lh)
+  {
+#ifdef LAPACK
+    if constexpr (is_same<SCAL,double>::value)
+      if (spd && d.Height() > 0)
+        {
+          HeapReset hr(lh);
+          FlatMatrix<double> save = d | lh;
+          if (LapackInverseSPD (d))
+            return;
+          d = save;
+        }
+#endif
+    CalcInverse (d);
+  }
+
  
   template <class SCAL, class TV>
   class BDDCMatrix : public BaseMatrix
@@ -56,6 +78,8 @@ namespace ngcomp
       : bfa(abfa), block(ablock), inversetype(ainversetype), coarsetype(acoarsetype)
     {
       static Timer timer ("BDDC Constructor");
+      static Timer timerdofs ("BDDC Constructor - element dofs");
+      static Timer timermats ("BDDC Constructor - allocate matrices");
 
       fes = bfa->GetFESpace();
       
@@ -85,7 +109,8 @@ namespace ngcomp
       
 
       LocalHeap lh(10000, "BDDC-constr, dummy heap");
-      
+
+      timerdofs.Start();
       for (auto vb : { VOL, BND, BBND })
         IterateElements 
           (*fes, vb, lh, 
@@ -186,14 +211,18 @@ namespace ngcomp
       wb_free_dofs->Clear();
 
       // *wb_free_dofs = wbdof;
-      for (auto i : Range(ndof))
-	if (fes->GetDofCouplingType(i) == WIREBASKET_DOF)
-	  wb_free_dofs -> SetBit(i);
+      ParallelFor (ndof, [&] (size_t i)
+                   {
+                     if (fes->GetDofCouplingType(i) == WIREBASKET_DOF)
+                       wb_free_dofs -> SetBitAtomic(i);
+                   });
 
 
       if (fes->GetFreeDofs())
 	wb_free_dofs -> And (*fes->GetFreeDofs());
-      
+      timerdofs.Stop();
+
+      RegionTimer regmats(timermats);
       if (!bfa->SymmetricStorage()) 
 	{
 	  harmonicexttrans = sparse_harmonicexttrans =
@@ -252,7 +281,7 @@ namespace ngcomp
       static Timer timer ("BDDC - Addmatrix", NoTracing);
       RegionTimer reg (timer);
       static Timer timer2("BDDC - Add to sparse", NoTracing, NoTiming);
-      static Timer timer3("BDDC - compute", NoTracing, NoTiming);
+      static Timer timer3("BDDC - local Schur complements", NoTracing);
 
       HeapReset hr(lh);
 
@@ -300,7 +329,7 @@ namespace ngcomp
           NgProfiler::AddThreadFlops (timer3, TaskManager::GetThreadId(),
                                       sizei*sizei*sizei + 2*sizei*sizei*sizew);
 
-          CalcInverse (d);  // , INVERSE_LIB::INV_NGBLA);
+          CalcInnerInverse (d, bfa->IsSPD(), lh);  
           
 	  if (sizew)
 	    {
@@ -363,7 +392,10 @@ namespace ngcomp
     void Finalize()
     {
       static Timer timer ("BDDC Finalize");
+      static Timer timerweights ("BDDC Finalize - weights");
+      static Timer timerwb ("BDDC Finalize - wirebasket inverse");
       RegionTimer reg(timer);
+      timerweights.Start();
 
       // auto fes = bfa->GetFESpace();
       int ndof = fes->GetNDof();      
@@ -406,8 +438,11 @@ namespace ngcomp
                        }, TasksPerThread(5));
         }
       
+      timerweights.Stop();
+      
       // now generate wire-basked solver
-
+      RegionTimer regwb(timerwb);
+      
       if (block)
 	{
           if (coarse)
@@ -485,9 +520,7 @@ namespace ngcomp
 	  else
 	    {
 
-              int cntfreedofs = 0;
-              for (int i = 0; i < wb_free_dofs->Size(); i++)
-                if (wb_free_dofs->Test(i)) cntfreedofs++;
+              size_t cntfreedofs = wb_free_dofs->NumSet();
 
               if (coarse)
               {
@@ -123,6 +123,8 @@ namespace ngcomp
                      !flags.GetDefineFlagX ("keep_internal").IsFalse() &&
                      !flags.GetDefineFlag ("nokeep_internal"));
     SetStoreInner (flags.GetDefineFlag ("store_inner"));
+    SetCondenseSinglePrecision (flags.GetDefineFlag ("condense_single"));
+    SetReuseElementMatrices (flags.GetDefineFlag ("reuse_elmats"));
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
     spd = flags.GetDefineFlag ("spd");
@@ -182,6 +184,8 @@ namespace ngcomp
     SetKeepInternal (eliminate_internal && 
                      !flags.GetDefineFlag ("nokeep_internal"));
     if (flags.GetDefineFlag ("store_inner")) SetStoreInner (1);
+    SetCondenseSinglePrecision (flags.GetDefineFlag ("condense_single"));
+    SetReuseElementMatrices (flags.GetDefineFlag ("reuse_elmats"));
     geom_free = flags.GetDefineFlag("geom_free");
     matrix_free_bdb = flags.GetDefineFlag("matrix_free_bdb");
     
@@ -1523,6 +1527,35 @@ namespace ngcomp
   template <class SCAL>
   S_BilinearForm<SCAL> :: ~S_BilinearForm () { ; }
 
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: CompressInternalMatrices ()
+  {
+    if (!condense_single || !keep_internal || !harmonicext) return;
+    for (auto m : { harmonicext_ptr, harmonicexttrans_ptr, innersolve_ptr, innermatrix_ptr })
+      if (m) m->CompressToSinglePrecision();
+  }
+
+  template <class SCAL>
+  Array<MemoryUsage> S_BilinearForm<SCAL> :: GetMemoryUsage () const
+  {
+    auto mu = BilinearForm::GetMemoryUsage();
+    if (reuse_elmats)
+      {
+        size_t nbytes = 0;
+        for (auto & cache : elmat_cache)
+          for (auto & elmat : cache.elmats)
+            nbytes += elmat.Size() * sizeof(SCAL);
+        mu.Append (MemoryUsage (string("element matrix cache bf ")+GetName(), nbytes, 1));
+      }
+    if (!keep_internal || !harmonicext) return mu;
+    int olds = mu.Size();
+    for (auto m : { harmonicext_ptr, harmonicexttrans_ptr, innersolve_ptr, innermatrix_ptr })
+      if (m) mu += m->GetMemoryUsage();
+    for (int i = olds; i < mu.Size(); i++)
+      mu[i].AddName (string(" condensation bf ")+GetName());
+    return mu;
+  }
+
   
   template <class SCAL>
   void S_BilinearForm<SCAL> :: AllocateInternalMatrices ()
@@ -1940,6 +1973,39 @@ namespace ngcomp
 
 	    mattimer1a.Stop();
 
+            // reuse_elmats: elements are identified with elements of the last
+            // assembly by their vertex numbers, which are kept by mesh refinement.
+            // A deformation moves elements without changing their vertices.
+            bool use_cache[2] = { false, false };
+            ElementMatrixCache old_cache[2];
+            unique_ptr<HashTable<INT<8>,size_t>> old_elements[2];
+            atomic<size_t> ncached(0);
+            if (reuse_elmats)
+              for (VorB vb : { VOL, BND })
+                {
+                  use_cache[vb] = VB_parts[vb].Size() && !printelmat && !elmat_ev &&
+                    !ma->GetDeformation();
+                  for (auto & bfi : VB_parts[vb])
+                    if (bfi->GetDefinedOnElements())
+                      use_cache[vb] = false;
+                  if (!use_cache[vb]) continue;
+
+                  old_cache[vb] = std::move(elmat_cache[vb]);
+                  old_elements[vb] = make_unique<HashTable<INT<8>,size_t>> (old_cache[vb].ndof.Size()+1);
+                  for (auto i : Range(old_cache[vb].ndof))
+                    if (old_cache[vb].ndof[i] >= 0)
+                      old_elements[vb]->Set (old_cache[vb].vertices[i], i);
+
+                  size_t ne = ma->GetNE(vb);
+                  auto & cache = elmat_cache[vb];
+                  cache.vertices.SetSize (ne);
+                  cache.index.SetSize (ne);
+                  cache.ndof.SetSize (ne);
+                  cache.ndof = -1;
+                  cache.elmats.SetSize (0);
+                  cache.elmats.SetSize (ne);
+                }
+
 	    for (VorB vb : { VOL, BND, BBND })
 	      {
 		if (!VB_parts[vb].Size()) continue;
@@ -2070,6 +2136,31 @@ namespace ngcomp
                          FlatMatrix<SCAL> sum_elmat(elmat_size, lh);
 			 bool elem_has_integrator = false;
 
+                         // curved elements may change their geometry by refinement
+                         bool cache_elmat = vb != BBND && use_cache[vb] && !eltrans.IsCurvedElement();
+                         bool from_cache = false;
+                         INT<8> vkey(-1);
+                         if (cache_elmat)
+                           {
+                             auto verts = el.Vertices();
+                             for (auto j : Range(verts))
+                               vkey[j] = verts[j];
+                             auto & old = old_cache[vb];
+                             if (old_elements[vb]->Used(vkey))
+                               {
+                                 size_t oldnr = old_elements[vb]->Get(vkey);
+                                 if (old.index[oldnr] == el.GetIndex() && old.ndof[oldnr] == elmat_size)
+                                   {
+                                     sum_elmat = FlatMatrix<SCAL> (elmat_size, elmat_size, old.elmats[oldnr].Data());
+                                     elmat_cache[vb].elmats[el.Nr()] = std::move(old.elmats[oldnr]);
+                                     elem_has_integrator = true;
+                                     from_cache = true;
+                                     ncached++;
+                                   }
+                               }
+                           }
+
+                         if (!from_cache)
                          {
                          static Timer elmattimer("calc elmats", NoTracing);
                          RegionTimer reg (elmattimer);
@@ -2176,6 +2267,19 @@ namespace ngcomp
                          } 
                          
                          if (!elem_has_integrator) return;
+
+                         if (cache_elmat)
+                           {
+                             auto & cache = elmat_cache[vb];
+                             cache.vertices[el.Nr()] = vkey;
+                             cache.index[el.Nr()] = el.GetIndex();
+                             cache.ndof[el.Nr()] = elmat_size;
+                             if (!from_cache)
+                               {
+                                 cache.elmats[el.Nr()].SetSize (sqr(elmat_size));
+                                 FlatMatrix<SCAL> (elmat_size, elmat_size, cache.elmats[el.Nr()].Data()) = sum_elmat;
+                               }
+                           }
                          
                          fespace->TransformMat (el, sum_elmat, TRANSFORM_MAT_LEFT_RIGHT);
 			 
@@ -2522,6 +2626,9 @@ namespace ngcomp
                   }
               }
 
+            if (reuse_elmats)
+              cout << IM(5) << "reused " << size_t(ncached) << " element matrices" << endl;
+
 
 	    //simplify
 	    // for (VorB vb : { VOL, BND })
@@ -3607,6 +3714,8 @@ namespace ngcomp
         if (checksum)
           cout << "|matrix| = " 
                << setprecision(16) << L2Norm (GetMatrix().AsVector()) << endl;
+
+        CompressInternalMatrices();
       }
     catch (Exception & e)
       {
@@ -4404,6 +4513,8 @@ namespace ngcomp
              << ", unused = " << useddof.Size()-cntused
              << ", total = " << useddof.Size() << endl;
 
+        CompressInternalMatrices();
+
         for (int j = 0; j < preconditioners.Size(); j++)
           preconditioners[j] -> FinalizeLevel(&GetMatrix());
       }
@@ -4999,9 +5110,10 @@ namespace ngcomp
           if ( (facetwise_skeleton_parts[VOL].Size() > 0) ||
                (facetwise_skeleton_parts[BND].Size() > 0) )
             
-            for (auto colfacets : fespace->FacetColoring())
+            for (auto & colbatches : fespace->GetFacetBatches())
               {
-                SharedLoop2 sl(colfacets.Size());
+                SharedLoop2 sl(colbatches.Size());
+                auto neighbours = fespace->GetFacetNeighbours();
 
                 ParallelJob
                   ( [&] (const TaskInfo & ti) 
@@ -5010,24 +5122,114 @@ namespace ngcomp
                       RegionTimer reg(timerDGpar);
 
                       Array<int> elnums(2, lh), elnums_per(2, lh), fnums1(6, lh), fnums2(6, lh),
-                        vnums1(8, lh), vnums2(8, lh);
+                        vnums1(8, lh), vnums2(8, lh), fvnums1(8, lh), fvnums2(8, lh);
+
+                      // interior facets with equal neighbour element classes,
+                      // integrators evaluate all facets of the batch at once
+                      auto apply_batch = [&] (FlatArray<int> batch) -> bool
+                        {
+                          if constexpr (!is_same<SCAL,double>::value)
+                            return false;
+                          else
+                            {
+                              if (facetwise_skeleton_parts[VOL].Size() == 0 ||
+                                  fespace->GetDimension() != 1) return false;
+
+                              RegionTimer reg2(timerDGapply);
+                              HeapReset hr(lh);
+                              size_t n = batch.Size();
+                              auto & nb0 = neighbours[batch[0]];
+                              ElementId ei1(VOL, nb0.el1), ei2(VOL, nb0.el2);
+                              const FiniteElement & fel1 = fespace->GetFE (ei1, lh);
+                              const FiniteElement & fel2 = fespace->GetFE (ei2, lh);
+                              size_t nd1 = fel1.GetNDof(), nd = nd1+fel2.GetNDof();
+                              vnums1 = ma->GetElVertices (ei1);
+                              vnums2 = ma->GetElVertices (ei2);
+
+                              Array<int> dnums1(nd1, lh), dnums2(nd-nd1, lh), dnums(n*nd, lh);
+                              FlatArray<const ElementTransformation*> trafos1(n, lh), trafos2(n, lh);
+                              FlatMatrix<SCAL> elx(n, nd, lh), ely(n, nd, lh);
+                              for (size_t k = 0; k < n; k++)
+                                {
+                                  auto & nb = neighbours[batch[k]];
+                                  ElementId fei1(VOL, nb.el1), fei2(VOL, nb.el2);
+                                  fespace->GetDofNrs (fei1, dnums1);
+                                  fespace->GetDofNrs (fei2, dnums2);
+                                  auto fdnums = dnums.Range(k*nd, (k+1)*nd);
+                                  fdnums.Range(0, nd1) = dnums1;
+                                  fdnums.Range(nd1, nd) = dnums2;
+                                  x.GetIndirect (fdnums, elx.Row(k));
+                                  this->fespace->TransformVec (fei1, elx.Row(k).Range(0, nd1), TRANSFORM_SOL);
+                                  this->fespace->TransformVec (fei2, elx.Row(k).Range(nd1, nd), TRANSFORM_SOL);
+                                  trafos1[k] = &ma->GetTrafo (fei1, lh);
+                                  trafos2[k] = &ma->GetTrafo (fei2, lh);
+                                }
+
+                              FlatArray<const ElementTransformation*> mapped_trafos1(n, lh), mapped_trafos2(n, lh);
+                              for (auto & bfi : facetwise_skeleton_parts[VOL])
+                                {
+                                  if (!bfi->DefinedOn (ma->GetElIndex (ei1))) continue;
+                                  if (!bfi->DefinedOn (ma->GetElIndex (ei2))) continue;
+
+                                  for (size_t k = 0; k < n; k++)
+                                    {
+                                      mapped_trafos1[k] = &trafos1[k]->AddDeformation(bfi->GetDeformation().get(), lh);
+                                      mapped_trafos2[k] = &trafos2[k]->AddDeformation(bfi->GetDeformation().get(), lh);
+                                    }
+
+                                  bool done = !bfi->GetDefinedOnElements() &&
+                                    bfi->ApplyFacetMatrixBatch (fel1, nb0.facnr1, mapped_trafos1, vnums1,
+                                                                fel2, nb0.facnr2, mapped_trafos2, vnums2, elx, ely, lh);
+                                  if (!done)
+                                    for (size_t k = 0; k < n; k++)
+                                      {
+                                        auto & nb = neighbours[batch[k]];
+                                        if (!bfi->DefinedOnElement (batch[k]))
+                                          {
+                                            ely.Row(k) = 0.0;
+                                            continue;
+                                          }
+                                        fvnums1 = ma->GetElVertices (ElementId(VOL, nb.el1));
+                                        fvnums2 = ma->GetElVertices (ElementId(VOL, nb.el2));
+                                        bfi->ApplyFacetMatrix (fel1, nb.facnr1, *mapped_trafos1[k], fvnums1,
+                                                               fel2, nb.facnr2, *mapped_trafos2[k], fvnums2,
+                                                               elx.Row(k), ely.Row(k), lh);
+                                      }
+
+                                  for (size_t k = 0; k < n; k++)
+                                    {
+                                      auto & nb = neighbours[batch[k]];
+                                      this->fespace->TransformVec (ElementId(VOL, nb.el1), ely.Row(k).Range(0, nd1), TRANSFORM_RHS);
+                                      this->fespace->TransformVec (ElementId(VOL, nb.el2), ely.Row(k).Range(nd1, nd), TRANSFORM_RHS);
+                                      y.AddIndirect (dnums.Range(k*nd, (k+1)*nd), ely.Row(k));
+                                    }
+                                }
+                              return true;
+                            }
+                        };
+
+                  for (int b : sl)
+                    {
+                      FlatArray<int> batch = colbatches[b];
+                      if (batch.Size() > 1 && apply_batch (batch)) continue;
 
-                  for (int i : sl)                
+                  for (int facet : batch)
                      {
                        // timerDG1.Start();
                        HeapReset hr(lh);
-                       int facet = colfacets[i];
-                       int facet2 = colfacets[i];
-                       ma->GetFacetElements (facet, elnums);
-                       if (elnums.Size() == 0) continue; // coarse facets
-                       int el1 = elnums[0];
-                       ElementId ei1(VOL, el1);
-                       fnums1 = ma->GetElFacets(ei1);
-                       int facnr1 = fnums1.Pos(facet);
+                       int facet2 = facet;
+                       auto & nb = neighbours[facet];
+                       if (nb.el1 == -1) continue; // coarse facets
+                       ElementId ei1(VOL, nb.el1);
+                       int facnr1 = nb.facnr1;
+                       ElementId ei2(VOL, nb.el2);
+                       int facnr2 = nb.facnr2;
                        
                        // timerDG1.Stop();
-                       if(elnums.Size() < 2)
+                       if (nb.el2 == -1)
                          {
+                           elnums.SetSize0();
+                           elnums.Append (nb.el1);
                            if (ma->GetCommunicator().Size() > 1)
                              if (ma->GetDistantProcs (NodeId(NT_FACET, facet)).Size() > 0)
                                continue;
@@ -5042,58 +5244,55 @@ namespace ngcomp
                              }
                            else if(facet2 < facet)
                              continue;
-                         }
-                       
-                       if (elnums.Size()<2)
-                         {
-                           // RegionTimer reg(timerDGfacet);
+
+                           if (elnums.Size()<2)
+                             {
+                               // RegionTimer reg(timerDGfacet);
                            
-                           ma->GetFacetSurfaceElements (facet, elnums);
-                           int sel = elnums[0];
-                           ElementId sei(BND, sel);
+                               ma->GetFacetSurfaceElements (facet, elnums);
+                               int sel = elnums[0];
+                               ElementId sei(BND, sel);
                            
-                           const FiniteElement & fel = fespace->GetFE (ei1, lh);
-                           Array<int> dnums(fel.GetNDof(), lh);
-                           vnums1 = ma->GetElVertices (ei1);
-                           vnums2 = ma->GetElVertices (sei);
+                               const FiniteElement & fel = fespace->GetFE (ei1, lh);
+                               Array<int> dnums(fel.GetNDof(), lh);
+                               vnums1 = ma->GetElVertices (ei1);
+                               vnums2 = ma->GetElVertices (sei);
                            
-                           ElementTransformation & eltrans = ma->GetTrafo (ei1, lh);
-                           ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
+                               ElementTransformation & eltrans = ma->GetTrafo (ei1, lh);
+                               ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
                            
-                           fespace->GetDofNrs (ei1, dnums);
+                               fespace->GetDofNrs (ei1, dnums);
                            
-                           for (auto & bfi : facetwise_skeleton_parts[BND])
-                             {
-                               if (!bfi->DefinedOn (seltrans.GetElementIndex())) continue;
-                               if (!bfi->DefinedOnElement (facet)) continue;
+                               for (auto & bfi : facetwise_skeleton_parts[BND])
+                                 {
+                                   if (!bfi->DefinedOn (seltrans.GetElementIndex())) continue;
+                                   if (!bfi->DefinedOnElement (facet)) continue;
                                          
-                               FlatVector<SCAL> elx(dnums.Size()*this->fespace->GetDimension(), lh),
-                                 ely(dnums.Size()*this->fespace->GetDimension(), lh);
-                               x.GetIndirect(dnums, elx);
-                               this->fespace->TransformVec (ei1, elx, TRANSFORM_SOL);
+                                   FlatVector<SCAL> elx(dnums.Size()*this->fespace->GetDimension(), lh),
+                                     ely(dnums.Size()*this->fespace->GetDimension(), lh);
+                                   x.GetIndirect(dnums, elx);
+                                   this->fespace->TransformVec (ei1, elx, TRANSFORM_SOL);
                                
-                               auto & mapped_trafo = eltrans.AddDeformation(bfi->GetDeformation().get(), lh);
-                               auto & mapped_strafo = seltrans.AddDeformation(bfi->GetDeformation().get(), lh);
-                               bfi->ApplyFacetMatrix (fel,facnr1,mapped_trafo,vnums1, mapped_strafo, vnums2, elx, ely, lh);
-                               this->fespace->TransformVec (ei1, ely, TRANSFORM_RHS);
-                               y.AddIndirect(dnums, ely, fespace->HasAtomicDofs());
-                             } //end for (numintegrators)
+                                   auto & mapped_trafo = eltrans.AddDeformation(bfi->GetDeformation().get(), lh);
+                                   auto & mapped_strafo = seltrans.AddDeformation(bfi->GetDeformation().get(), lh);
+                                   bfi->ApplyFacetMatrix (fel,facnr1,mapped_trafo,vnums1, mapped_strafo, vnums2, elx, ely, lh);
+                                   this->fespace->TransformVec (ei1, ely, TRANSFORM_RHS);
+                                   y.AddIndirect(dnums, ely, fespace->HasAtomicDofs());
+                                 } //end for (numintegrators)
                            
-                           continue;
-                         } // end if boundary facet
+                               continue;
+                             } // end if boundary facet
+
+                           // periodic facet
+                           ei2 = ElementId(VOL, elnums[1]);
+                           facnr2 = ma->GetElFacets(ei2).Pos(facet2);
+                         }
                        
                        if (facetwise_skeleton_parts[VOL].Size() == 0)
                          continue;
                        
                        // timerDG2.Start();
                        // timerDG2a.Start();
-                       // int el2 = elnums[1];
-                       // ElementId ei2(VOL, el2);
-                       ElementId ei2(VOL, elnums[1]);
-                       
-                       // fnums2 = ma->GetElFacets(ei2);
-                       // int facnr2 = fnums2.Pos(facet2);
-                       int facnr2 = ma->GetElFacets(ei2).Pos(facet2);
 
                        ElementTransformation & eltrans1 = ma->GetTrafo (ei1, lh);
                        ElementTransformation & eltrans2 = ma->GetTrafo (ei2, lh);
@@ -5136,6 +5335,7 @@ namespace ngcomp
                            y.AddIndirect(dnums, ely);
                          }
                      }
+                    }
                  });
               }
           
@@ -7536,7 +7736,7 @@ namespace ngcomp
     if ( !low_order_bilinear_form )
       for (int finelevel = ma->GetNLevels()-1; finelevel>0; finelevel--)
         {
-          auto prolMat = prol->CreateProlongationMatrix (finelevel);
+          auto prolMat = prol->GetProlongationMatrix (finelevel);
           
           if (prolMat)					  
             mats[finelevel-1] = dynamic_cast< const BaseSparseMatrix& >(GetMatrix(finelevel)).
@@ -113,6 +113,10 @@ namespace ngcomp
     bool keep_internal;
     /// should A_ii itself be stored?!
     bool store_inner; 
+    /// store condensation matrices in single precision
+    bool condense_single = false;
+    /// reuse element matrices of elements unchanged by mesh refinement
+    bool reuse_elmats = false;
     
     /// precomputes some data for each element
     bool precompute;
@@ -377,6 +381,12 @@ namespace ngcomp
     void SetStoreInner (bool storei) 
     { store_inner = storei; }
 
+    void SetCondenseSinglePrecision (bool single)
+    { condense_single = single; }
+
+    void SetReuseElementMatrices (bool reuse)
+    { reuse_elmats = reuse; }
+
     void SetPrint (bool ap);
     void SetPrintElmat (bool ap);
     void SetElmatEigenValues (bool ee);
@@ -454,6 +464,19 @@ namespace ngcomp
     // local operators:
     ElementByElementMatrix<SCAL> *harmonicext_ptr, *harmonicexttrans_ptr, *innersolve_ptr, *innermatrix_ptr;
 
+    /// converts the local operators to single precision (flag condense_single)
+    void CompressInternalMatrices ();
+
+    /// element matrices of the last assembly (flag reuse_elmats), for VOL and BND
+    struct ElementMatrixCache
+    {
+      Array<INT<8>> vertices;
+      Array<int> index;
+      Array<int> ndof;     // -1 if no matrix is stored
+      Array<Array<SCAL>> elmats;
+    };
+    ElementMatrixCache elmat_cache[2];
+
     
     //data for mpi-facets; only has data if there are relevant integrators in the BLF!
     mutable bool have_mpi_facet_data = false;
@@ -586,6 +609,9 @@ namespace ngcomp
 				       LocalHeap & lh);
 
 
+    /// includes the stored condensation matrices
+    Array<MemoryUsage> GetMemoryUsage () const override;
+
     shared_ptr<BaseMatrix> GetHarmonicExtension () const override
     { 
       return harmonicext; 
@@ -0,0 +1,206 @@
+/**********************************************************************/
+/* File:   cfintegrator.cpp                                           */
+/**********************************************************************/
+
+/*
+   Reusable integration of CoefficientFunctions over (parts of) the mesh
+*/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  CFIntegrator :: CFIntegrator (shared_ptr<MeshAccess> ama, VorB avb,
+                                Array<shared_ptr<CoefficientFunction>> acfs,
+                                int aorder, const BitArray * definedon,
+                                bool compile)
+    : ma(ama), vb(avb), order(aorder), cfs(std::move(acfs))
+  {
+    static Timer t("CFIntegrator - setup"); RegionTimer reg(t);
+
+    if (!cfs.Size())
+      throw Exception ("CFIntegrator: no CoefficientFunction given");
+
+    dim = 0;
+    is_complex = false;
+    first_comp.SetSize(cfs.Size()+1);
+    for (size_t i = 0; i < cfs.Size(); i++)
+      {
+        cfs[i] -> TraverseTree
+          ([&] (CoefficientFunction & stepcf)
+           {
+             if (dynamic_cast<ProxyFunction*>(&stepcf))
+               throw Exception("Cannot integrate ProxFunction!");
+           });
+        first_comp[i] = dim;
+        dim += cfs[i]->Dimension();
+        is_complex |= cfs[i]->IsComplex();
+      }
+    first_comp[cfs.Size()] = dim;
+
+    cf = (cfs.Size() == 1) ? cfs[0] : MakeVectorialCoefficientFunction (Array<shared_ptr<CoefficientFunction>>(cfs));
+    if (compile)
+      cf = Compile (cf, false);
+
+    Array<bool> used_et(ET_HEX+1);
+    used_et = false;
+    for (auto el : ma->Elements(vb))
+      if (!definedon || definedon->Test(el.GetIndex()))
+        {
+          elements.Append (el.Nr());
+          used_et[el.GetType()] = true;
+        }
+
+    simd_rules.SetSize(ET_HEX+1);
+    rules.SetSize(ET_HEX+1);
+    for (auto et : element_types)
+      if (used_et[et])
+        {
+          simd_rules[et] = make_unique<SIMD_IntegrationRule> (et, order);
+          rules[et] = make_unique<IntegrationRule> (et, order);
+        }
+  }
+
+
+  // pairwise summation of the block sums
+  template <typename SCAL>
+  static void PairwiseSum (FlatMatrix<SCAL> blocksums, FlatVector<SCAL> sum)
+  {
+    size_t n = blocksums.Height();
+    if (n == 0)
+      sum = SCAL(0.0);
+    else if (n == 1)
+      sum = blocksums.Row(0);
+    else
+      {
+        STACK_ARRAY(SCAL, mem, sum.Size());
+        FlatVector<SCAL> sum2(sum.Size(), &mem[0]);
+        PairwiseSum (blocksums.Rows(0, n/2), sum);
+        PairwiseSum (blocksums.Rows(n/2, n), sum2);
+        sum += sum2;
+      }
+  }
+
+
+  template <typename SCAL>
+  Vector<SCAL> CFIntegrator :: T_Integrate (LocalHeap & clh, FlatMatrix<SCAL> elvals) const
+  {
+    static Timer t("CFIntegrator"); RegionTimer reg(t);
+
+    constexpr size_t blocksize = 128;
+    size_t nblocks = (elements.Size()+blocksize-1) / blocksize;
+    Matrix<SCAL> blocksums(nblocks, dim);
+    bool elementwise = elvals.Height() > 0;
+
+    auto IntegrateElement = [&] (int elnr, FlatVector<SCAL> elsum, LocalHeap & lh)
+      {
+        ElementId ei(vb, elnr);
+        auto & trafo = ma->GetTrafo (ei, lh);
+        ELEMENT_TYPE et = trafo.GetElementType();
+
+        if (use_simd)
+          {
+            try
+              {
+                auto & mir = trafo(*simd_rules[et], lh);
+                FlatMatrix<SIMD<SCAL>> values(dim, mir.Size(), lh);
+                cf -> Evaluate (mir, values);
+                for (size_t j = 0; j < dim; j++)
+                  {
+                    SIMD<SCAL> vsum = SCAL(0.0);
+                    for (size_t i = 0; i < values.Width(); i++)
+                      vsum += mir[i].GetWeight() * values(j,i);
+                    elsum(j) = HSum(vsum);
+                  }
+                return;
+              }
+            catch (const ExceptionNOSIMD& e)
+              {
+                use_simd = false;
+              }
+          }
+
+        auto & mir = trafo(*rules[et], lh);
+        FlatMatrix<SCAL> values(mir.Size(), dim, lh);
+        cf -> Evaluate (mir, values);
+        elsum = SCAL(0.0);
+        for (size_t i = 0; i < values.Height(); i++)
+          elsum += mir[i].GetWeight() * values.Row(i);
+      };
+
+    auto IntegrateBlock = [&] (size_t bnr, LocalHeap & lh)
+      {
+        HeapReset hrb(lh);
+        auto r = Range(elements).Split (bnr, nblocks);
+        FlatVector<SCAL> sum = blocksums.Row(bnr);
+        FlatVector<SCAL> comp(dim, lh), elsum(dim, lh);
+        sum = SCAL(0.0);
+        comp = SCAL(0.0);
+        for (size_t i : r)
+          {
+            HeapReset hr(lh);
+            IntegrateElement (elements[i], elsum, lh);
+            if (elementwise)
+              elvals.Row(elements[i]) = elsum;
+
+            // compensated summation
+            for (size_t j = 0; j < dim; j++)
+              {
+                SCAL y = elsum(j) - comp(j);
+                SCAL tsum = sum(j) + y;
+                comp(j) = (tsum - sum(j)) - y;
+                sum(j) = tsum;
+              }
+          }
+      };
+
+    if (task_manager)
+      {
+        SharedLoop sl(nblocks);
+        task_manager -> CreateJob
+          ( [&] (const TaskInfo & ti)
+            {
+              LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+              for (size_t bnr : sl)
+                IntegrateBlock (bnr, lh);
+            } );
+      }
+    else
+      for (size_t bnr : Range(nblocks))
+        IntegrateBlock (bnr, clh);
+
+    Vector<SCAL> sum(dim);
+    PairwiseSum<SCAL> (blocksums, sum);
+
+#ifdef PARALLEL
+    if (ma->GetCommunicator().Size() > 1)
+      MPI_Allreduce(MPI_IN_PLACE, &sum(0), dim, GetMPIType<SCAL>(), MPI_SUM, ma->GetCommunicator());
+#endif
+    return sum;
+  }
+
+
+  Vector<double> CFIntegrator :: Integrate (LocalHeap & lh) const
+  {
+    return Integrate (lh, FlatMatrix<double>(0, dim, nullptr));
+  }
+
+  Vector<Complex> CFIntegrator :: IntegrateComplex (LocalHeap & lh) const
+  {
+    return IntegrateComplex (lh, FlatMatrix<Complex>(0, dim, nullptr));
+  }
+
+  Vector<double> CFIntegrator :: Integrate (LocalHeap & lh, FlatMatrix<double> elvals) const
+  {
+    if (is_complex)
+      throw Exception ("CFIntegrator: complex CoefficientFunction, use IntegrateComplex");
+    return T_Integrate<double> (lh, elvals);
+  }
+
+  Vector<Complex> CFIntegrator :: IntegrateComplex (LocalHeap & lh, FlatMatrix<Complex> elvals) const
+  {
+    return T_Integrate<Complex> (lh, elvals);
+  }
+
+}
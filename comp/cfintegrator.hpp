@@ -0,0 +1,80 @@
+#ifndef FILE_CFINTEGRATOR
+#define FILE_CFINTEGRATOR
+
+/**********************************************************************/
+/* File:   cfintegrator.hpp                                           */
+/**********************************************************************/
+
+/*
+   Reusable integration of CoefficientFunctions over (parts of) the mesh
+*/
+
+
+namespace ngcomp
+{
+
+  /**
+     Integrates a list of CoefficientFunctions over the elements of a region.
+
+     The setup (element list, compiled CF, integration rules) is done once,
+     Integrate can be called many times, e.g. in every time step, when the
+     GridFunctions inside the CFs have changed. All CFs are evaluated in one
+     element loop. Sums are accumulated blockwise with compensated (Kahan)
+     summation and combined pairwise, the result does not depend on the
+     number of threads.
+
+     For curved meshes the geometry of the mapped integration rules can be
+     cached by MeshAccess::EnableGeometryCache.
+  */
+  class NGS_DLL_HEADER CFIntegrator
+  {
+    shared_ptr<MeshAccess> ma;
+    VorB vb;
+    int order;
+    Array<shared_ptr<CoefficientFunction>> cfs;
+    // all cfs as one vectorial (and compiled) cf
+    shared_ptr<CoefficientFunction> cf;
+    Array<int> first_comp;
+    int dim;
+    bool is_complex;
+    // the elements to integrate on
+    Array<int> elements;
+    // integration rules per element type
+    Array<unique_ptr<SIMD_IntegrationRule>> simd_rules;
+    Array<unique_ptr<IntegrationRule>> rules;
+    // switched off by the first element which cannot be evaluated with SIMD
+    mutable atomic<bool> use_simd{true};
+
+  public:
+    CFIntegrator (shared_ptr<MeshAccess> ama, VorB avb,
+                  Array<shared_ptr<CoefficientFunction>> acfs,
+                  int aorder, const BitArray * definedon = nullptr,
+                  bool compile = true);
+
+    shared_ptr<MeshAccess> GetMeshAccess() const { return ma; }
+    VorB GetVorB() const { return vb; }
+    /// number of components of all cfs together
+    int Dimension() const { return dim; }
+    bool IsComplex() const { return is_complex; }
+    /// components of cf nr i are first[i] ... first[i+1]
+    FlatArray<int> FirstComponent() const { return first_comp; }
+
+    /// integrals of all components, summed over MPI ranks
+    Vector<double> Integrate (LocalHeap & lh) const;
+    Vector<Complex> IntegrateComplex (LocalHeap & lh) const;
+
+    /*
+      Additionally stores the element-wise integrals, elvals must be
+      of size ne(vb) x Dimension(). Elements outside the region are not touched.
+    */
+    Vector<double> Integrate (LocalHeap & lh, FlatMatrix<double> elvals) const;
+    Vector<Complex> IntegrateComplex (LocalHeap & lh, FlatMatrix<Complex> elvals) const;
+
+  private:
+    template <typename SCAL>
+    Vector<SCAL> T_Integrate (LocalHeap & lh, FlatMatrix<SCAL> elvals) const;
+  };
+
+}
+
+#endif
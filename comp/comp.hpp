@@ -62,6 +62,9 @@ namespace ngcomp
 
 #include "postproc.hpp"
 #include "interpolate.hpp"
+#include "cfintegrator.hpp"
+#include "timestepping.hpp"
+#include "pmultigrid.hpp"
 
 #include "tpfes.hpp"
 #include "hcurlhdivfes.hpp"
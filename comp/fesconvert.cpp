@@ -10,6 +10,13 @@ namespace ngcomp
   template<int BSA, int BSB, typename SCAL> using TM = typename TM_TRAIT<BSA, BSB, SCAL>::type;
   template<int BSA, int BSB, typename SCAL> using TSPM = SparseMatrix<TM<BSA, BSB, SCAL>>;
 
+  /*
+    Sparse conversion matrix, the local operators are computed on every
+    element, also on affine ones. Sharing them between elements of the same
+    class is only correct if the spaces (and trial_cf) map alike, which is
+    not checked here; the geometry-free version ConvertOperatorGF does so
+    on request of the user.
+  */
   template<class SCAL, int DIMA, int DIMB>
   shared_ptr<BaseMatrix> ConvertOperator (shared_ptr<FESpace> space_a, shared_ptr<FESpace> space_b,
 					  // int inda, int indb,
@@ -358,116 +365,143 @@ namespace ngcomp
     /** Create Matrix Graph **/
     int dima = space_a->GetDimension(), dimb = space_b->GetDimension();
 
-    /** element equivalence classes **/
-    // LocalHeap lh(10000000);
-
-    /** #of equivalence classes per element type **/
-    Array<short> et_eqc_cnt(ET_HEX+1); et_eqc_cnt = 0;
-    ma->IterateElements
-      (vb, lh, [&] (auto el, LocalHeap & llh) {
-	short anum = 1 +
-	  SwitchET (el.GetType(),
-		    [&] (auto et) { return ET_trait<et.ElementType()>::GetClassNr(el.Vertices()); });
-	et_eqc_cnt[int(el.GetType())] = max(et_eqc_cnt[int(el.GetType())], anum);
-      });
-    /** prefix-sum so we have a unique nr for every element-type/element-eqc pair **/
-    Array<short> et_firsti(ET_HEX+2); et_firsti = 0;
-    for (auto k : Range(et_eqc_cnt))
-      { et_firsti[k+1] = et_eqc_cnt[k] + et_firsti[k]; }
-    /** actual class nrs **/
-    Array<short> classnr(ma->GetNE(vb));
-    ma->IterateElements
-      (vb, lh, [&] (auto el, LocalHeap & llh) 
-      {
-        if ( (space_a->DefinedOn(vb, el.GetIndex())) && (space_b->DefinedOn(vb, el.GetIndex())) )
-        {
-            classnr[el.Nr()] =
-            SwitchET
-            (el.GetType(),
-            [&] (auto et) { return et_firsti[int(et)] + ET_trait<et.ElementType()>::GetClassNr(el.Vertices()); });
-        }
-        else
-        {classnr[el.Nr()] = -1;}
-      });
-    
-    TableCreator<size_t> creator;
+    static Timer tclass ("ConvertOperatorGF - classes");
+    static Timer telmat ("ConvertOperatorGF - elmats");
+    static Timer tdofs ("ConvertOperatorGF - dofs");
+
+    /**
+       element equivalence classes: element type, vertex ordering class and
+       the local number of dofs of both spaces (which catches varying orders).
+       All elements of a class share the same local operator.
+    **/
+    size_t ne = ma->GetNE(vb);
+    Array<INT<3>> elkey(ne);
+    tclass.Start();
+    ParallelForRange
+      (ne, [&](IntRange r)
+       {
+         Array<DofId> dnumsa, dnumsb;
+         for (auto i : r) {
+           ElementId ei(vb, i);
+           Ngs_Element el = ma->GetElement(ei);
+           if ( (!space_a->DefinedOn(vb, el.GetIndex())) || (!space_b->DefinedOn(vb, el.GetIndex())) ||
+                (reg && !reg->Mask().Test(el.GetIndex())) )
+             { elkey[i] = INT<3>(-1); continue; }
+           int eqc = SwitchET (el.GetType(),
+                               [&] (auto et) { return ET_trait<et.ElementType()>::GetClassNr(el.Vertices()); });
+           space_a->GetDofNrs(ei, dnumsa);
+           space_b->GetDofNrs(ei, dnumsb);
+           elkey[i] = INT<3>((ET_HEX+1) * eqc + int(el.GetType()), dnumsa.Size(), dnumsb.Size());
+         }
+       });
+
+    /** numbering of the classes, in order of first appearance **/
+    std::map<tuple<int,int,int>, int> key2class;
+    Array<int> classnr(ne);
+    for (auto i : Range(ne)) {
+      if (elkey[i][0] == -1)
+        { classnr[i] = -1; continue; }
+      auto key = make_tuple(elkey[i][0], elkey[i][1], elkey[i][2]);
+      auto pos = key2class.find(key);
+      if (pos == key2class.end())
+        { pos = key2class.emplace(key, int(key2class.size())).first; }
+      classnr[i] = pos->second;
+    }
+    size_t nclasses = key2class.size();
+
+    TableCreator<size_t> creator(nclasses);
     for ( ; !creator.Done(); creator++)
-      for (auto i : Range(classnr))
-        { if (classnr[i] != -1){creator.Add (classnr[i], i);} } //{ creator.Add (classnr[i], i); }
+      ParallelFor (ne, [&](size_t i)
+        { if (classnr[i] != -1) { creator.Add (classnr[i], i); } });
     Table<size_t> table = creator.MoveTable();
+    /** same element order as a sequential build **/
+    ParallelFor (table.Size(), [&](size_t k) { QuickSort (table[k]); });
+    tclass.Stop();
 
     /** assemble element matrix for every equivalence class **/
-    Array<int> cnt_b(space_b->GetNDof()); cnt_b = 0;
+    Array<Matrix<SCAL>> elmats(nclasses);
+    Array<bool> simd_failed(nclasses);
+    simd_failed = false;
 
-    shared_ptr<BaseMatrix> op;
-
-    auto simd_guard = [&](auto some_lam) {
-      if (use_simd) {
-	try { some_lam(); }
-	catch (const ExceptionNOSIMD& e) { /** Turn off SIMD and continue **/
-	  for (auto bfi : ab_bfis)
-	    { bfi->SetSimdEvaluate(false); }
-	  for (auto bfi : bb_bfis)
-	    { bfi->SetSimdEvaluate(false); }
-	  some_lam();
-	}
-      }
-      else
-	{ some_lam(); }
+    auto calc_elmats = [&](auto use_class) {
+      ParallelFor (nclasses, [&](size_t k)
+        {
+          if (!use_class(k)) return;
+          LocalHeap slh = lh.Split();
+          ElementId ei(vb, table[k][0]);
+
+          auto & eltrans = ma->GetTrafo(ei, slh);
+
+          auto & fela = space_a->GetFE (ei, slh); int nda = fela.GetNDof();
+          auto & felb = space_b->GetFE (ei, slh); int ndb = felb.GetNDof();
+          MixedFiniteElement felab(fela, felb);
+
+          FlatMatrix<SCAL> bamat(ndb*dimb, nda*dima, slh), bbmat(ndb*dimb, ndb*dimb, slh);
+
+          try {
+            bamat = 0.0; bbmat = 0.0;
+            bool symmetric_so_far = true; // will be set to false here
+            for (auto bfi : ab_bfis)
+              { bfi->CalcElementMatrixAdd(felab, eltrans, bamat, symmetric_so_far, slh); }
+            symmetric_so_far = true; // will probably be set to false
+            for (auto bfi : bb_bfis)
+              { bfi->CalcElementMatrixAdd(felb, eltrans, bbmat, symmetric_so_far, slh); }
+          }
+          catch (const ExceptionNOSIMD & e)
+            { simd_failed[k] = true; return; }
+
+          CalcInverse(bbmat);
+          elmats[k].SetSize(ndb*dimb, nda*dima);
+          elmats[k] = bbmat * bamat;
+        });
     };
 
-    for (auto elclass_inds : table) {
-
-      HeapReset hr(lh);
-
-      if (elclass_inds.Size() == 0) continue;
-
-      ElementId ei(vb, elclass_inds[0]);
-
-      auto & eltrans = ma->GetTrafo(ei, lh);
-
-      auto & fela = space_a->GetFE (ei, lh); int nda = fela.GetNDof();
-      auto & felb = space_b->GetFE (ei, lh); int ndb = felb.GetNDof();
-      MixedFiniteElement felab(fela, felb);
-
-      FlatMatrix<SCAL> bamat(ndb*dimb, nda*dima, lh), bbmat(ndb*dimb, ndb*dimb, lh),
-	elmat(ndb*dimb, nda*dima, lh);
-
-      simd_guard([&]() {
-	  bamat = 0.0; bbmat = 0.0;
-	  bool symmetric_so_far = true; // will be set to false here
-	  for (auto bfi : ab_bfis)
-	    { bfi->CalcElementMatrixAdd(felab, eltrans, bamat, symmetric_so_far, lh); }
-	  symmetric_so_far = true; // will probably be set to false
-	  for (auto bfi : bb_bfis)
-	    { bfi->CalcElementMatrixAdd(felb, eltrans, bbmat, symmetric_so_far, lh); }
-	});
-
-      CalcInverse(bbmat);
-      elmat = bbmat * bamat;
+    telmat.Start();
+    calc_elmats([](size_t k) { return true; });
+    if (simd_failed.Contains(true)) { /** Turn off SIMD and redo the failed classes **/
+      for (auto bfi : ab_bfis)
+        { bfi->SetSimdEvaluate(false); }
+      for (auto bfi : bb_bfis)
+        { bfi->SetSimdEvaluate(false); }
+      calc_elmats([&](size_t k) { return simd_failed[k]; });
+    }
+    telmat.Stop();
 
-      Table<DofId> adofs(elclass_inds.Size(), nda*dima),
-	bdofs(elclass_inds.Size(), ndb*dimb);
-      Array<DofId> dnumsa, dnumsb;
-      for (auto i : Range(elclass_inds)) {
-	ElementId ei(vb, elclass_inds[i]);
-	space_a->GetDofNrs(ei, dnumsa);
-	space_b->GetDofNrs(ei, dnumsb);
-	for (auto d : dnumsb)
-	  { cnt_b[d]++; }
-	int c = 0;
-	for (auto l : Range(dnumsa))
-	  for (auto ll : Range(dima))
-	    { adofs[i][c++] = dima * dnumsa[l] + ll; }
-	c = 0;
-	for (auto l : Range(dnumsb))
-	  for (auto ll : Range(dimb))
-	    { bdofs[i][c++] = dimb * dnumsb[l] + ll; }
-      }
+    /** dof tables, and number of elements per b-dof for averaging **/
+    tdofs.Start();
+    Array<int> cnt_b(space_b->GetNDof()); cnt_b = 0;
+    Array<Table<DofId>> adofs(nclasses), bdofs(nclasses);
+    for (auto k : Range(nclasses)) {
+      adofs[k] = Table<DofId>(table[k].Size(), elmats[k].Width());
+      bdofs[k] = Table<DofId>(table[k].Size(), elmats[k].Height());
+      ParallelForRange
+        (table[k].Size(), [&](IntRange r)
+         {
+           Array<DofId> dnumsa, dnumsb;
+           for (auto i : r) {
+             ElementId ei(vb, table[k][i]);
+             space_a->GetDofNrs(ei, dnumsa);
+             space_b->GetDofNrs(ei, dnumsb);
+             for (auto d : dnumsb)
+               { AsAtomic(cnt_b[d])++; }
+             int c = 0;
+             for (auto l : Range(dnumsa))
+               for (auto ll : Range(dima))
+                 { adofs[k][i][c++] = dima * dnumsa[l] + ll; }
+             c = 0;
+             for (auto l : Range(dnumsb))
+               for (auto ll : Range(dimb))
+                 { bdofs[k][i][c++] = dimb * dnumsb[l] + ll; }
+           }
+         });
+    }
+    tdofs.Stop();
 
+    shared_ptr<BaseMatrix> op;
+    for (auto k : Range(nclasses)) {
       auto mat = make_shared<ConstantElementByElementMatrix>
 	(space_b->GetNDof(), space_a->GetNDof(),
-	 elmat, std::move(bdofs), std::move(adofs));
+	 std::move(elmats[k]), std::move(bdofs[k]), std::move(adofs[k]));
 
       if (op != nullptr)
 	{ op = make_shared<SumMatrix>(op, mat); }
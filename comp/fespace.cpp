@@ -519,6 +519,155 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
 
 
+  static void SortUnique (Array<DofId> & dofs)
+  {
+    QuickSort (dofs);
+    size_t cnt = 0;
+    for (size_t i = 0; i < dofs.Size(); i++)
+      if (i == 0 || dofs[i] != dofs[cnt-1])
+        dofs[cnt++] = dofs[i];
+    dofs.SetSize(cnt);
+  }
+
+  /*
+    Parallel greedy coloring with speculative color choice and conflict
+    resolution: items sharing a dof get different colors.
+
+    GetDofs(item, dofs) returns false if the item is not colored, the dofs
+    must be unique. Every item picks the smallest color not yet seen on its
+    dofs, and claims the color bit on all its dofs with an atomic fetch_or.
+    If the bit was already set on some dof, another item sharing this dof
+    got the color first, and the item tries again in the next sweep (with
+    this color now excluded). Colors are handled in windows of 32 bits.
+  */
+  template <typename TFUNC>
+  static Array<int> ParallelColoring (size_t n, size_t ndof, TFUNC GetDofs)
+  {
+    Array<int> col(n);
+    Array<unsigned int> mask(ndof);
+    atomic<size_t> remaining(0);
+
+    ParallelForRange
+      (n, [&] (IntRange myrange)
+       {
+         Array<DofId> dofs;
+         size_t mycnt = 0;
+         for (size_t i : myrange)
+           {
+             bool use = GetDofs(i, dofs);
+             col[i] = use ? -1 : -2;
+             if (use) mycnt++;
+           }
+         remaining += mycnt;
+       });
+
+    int basecol = 0;
+    while (remaining > 0)
+      {
+        ParallelForRange
+          (mask.Size(), [&] (IntRange myrange) { mask[myrange] = 0; });
+
+        bool tried = true;
+        while (tried && remaining > 0)
+          {
+            atomic<bool> anytried(false);
+            ParallelForRange
+              (n, [&] (IntRange myrange)
+               {
+                 Array<DofId> dofs;
+                 size_t mycolored = 0;
+                 bool mytried = false;
+                 for (size_t i : myrange)
+                   {
+                     if (col[i] != -1) continue;
+                     GetDofs(i, dofs);
+
+                     unsigned check = 0;
+                     for (auto d : dofs)
+                       check |= AsAtomic(mask[d]).load(memory_order_relaxed);
+                     if (check == UINT_MAX) continue;   // wait for the next window
+
+                     mytried = true;
+                     int bitnr = 0;
+                     while (check & (1u << bitnr)) bitnr++;
+                     unsigned checkbit = 1u << bitnr;
+
+                     bool ok = true;
+                     for (auto d : dofs)
+                       if (AsAtomic(mask[d]).fetch_or(checkbit, memory_order_relaxed) & checkbit)
+                         {
+                           ok = false;
+                           break;
+                         }
+                     if (ok)
+                       {
+                         col[i] = basecol + bitnr;
+                         mycolored++;
+                       }
+                   }
+                 remaining -= mycolored;
+                 if (mytried) anytried = true;
+               });
+            tried = anytried;
+          }
+        basecol += 8*sizeof(unsigned int); // 32;
+      }
+    return col;
+  }
+
+  // items of color c, ascending, built in parallel. Items with col < 0 are skipped
+  static Table<int> ColoringTable (FlatArray<int> col)
+  {
+    size_t n = col.Size();
+    size_t nblocks = min(n/1024+1, size_t(8*max(TaskManager::GetNumThreads(), 1)));
+
+    Array<int> blockmax(nblocks);
+    ParallelFor (nblocks, [&] (size_t b)
+      {
+        int mymax = -1;
+        for (size_t i : Range(n).Split(b, nblocks))
+          mymax = max(mymax, col[i]);
+        blockmax[b] = mymax;
+      });
+    int ncol = 0;
+    for (int m : blockmax)
+      ncol = max(ncol, m+1);
+
+    // first position of block b in color c
+    Array<int> pos(nblocks*ncol);
+    ParallelFor (nblocks, [&] (size_t b)
+      {
+        FlatArray<int> mypos = pos.Range(b*ncol, (b+1)*ncol);
+        mypos = 0;
+        for (size_t i : Range(n).Split(b, nblocks))
+          if (col[i] >= 0) mypos[col[i]]++;
+      });
+
+    Array<int> cntcol(ncol);
+    for (int c = 0; c < ncol; c++)
+      {
+        int sum = 0;
+        for (size_t b = 0; b < nblocks; b++)
+          {
+            int cnt = pos[b*ncol+c];
+            pos[b*ncol+c] = sum;
+            sum += cnt;
+          }
+        cntcol[c] = sum;
+      }
+
+    Table<int> table(cntcol);
+    ParallelFor (nblocks, [&] (size_t b)
+      {
+        FlatArray<int> mypos = pos.Range(b*ncol, (b+1)*ncol);
+        for (size_t i : Range(n).Split(b, nblocks))
+          if (col[i] >= 0)
+            table[col[i]][mypos[col[i]]++] = i;
+      });
+    return table;
+  }
+
+
   void FESpace :: FinalizeUpdate()
   {
     static Timer timer ("FESpace::FinalizeUpdate");
@@ -604,29 +753,46 @@ lot of new non-zero entries in the matrix!\n" << endl;
              }
        });
 
-    Array<DofId> dnums;             
-    for (int i : Range(dirichlet_face))
-      if (dirichlet_face[i])
-	{
-	  GetFaceDofNrs (i, dnums);
-	  for (DofId d : dnums)
-	    if (IsRegularDof(d)) dirichlet_dofs.SetBit (d);
-	}
+    ParallelForRange
+      (dirichlet_face.Size(),
+       [&] (IntRange r)
+       {
+         Array<DofId> dnums;
+         for (auto i : r)
+           if (dirichlet_face[i])
+             {
+               GetFaceDofNrs (i, dnums);
+               for (DofId d : dnums)
+                 if (IsRegularDof(d)) dirichlet_dofs.SetBitAtomic (d);
+             }
+       });
     
     // tcolbits.Start();
     free_dofs = make_shared<BitArray>(GetNDof());
     *free_dofs = dirichlet_dofs;
     free_dofs->Invert();
-    
-    for (auto i : Range(ctofdof))
-      if (!(ctofdof[i] & VISIBLE_DOF)) //hidden or unused
-	free_dofs->Clear(i);
 
     external_free_dofs = make_shared<BitArray>(GetNDof());
+    
+    // chunks of 8 dofs share a byte of the bitarrays
+    ParallelForRange
+      ((ctofdof.Size()+7)/8,
+       [&] (IntRange r)
+       {
+         for (auto i : Range(8*r.First(), min(8*r.Next(), ctofdof.Size())))
+           if (!(ctofdof[i] & VISIBLE_DOF)) //hidden or unused
+             free_dofs->Clear(i);
+       });
+
     *external_free_dofs = *free_dofs;
-    for (auto i : Range(ctofdof))
-      if (ctofdof[i] & CONDENSABLE_DOF)
-	external_free_dofs->Clear(i);
+    ParallelForRange
+      ((ctofdof.Size()+7)/8,
+       [&] (IntRange r)
+       {
+         for (auto i : Range(8*r.First(), min(8*r.Next(), ctofdof.Size())))
+           if (ctofdof[i] & CONDENSABLE_DOF)
+             external_free_dofs->Clear(i);
+       });
 
     if (print)
       *testout << "freedofs = " << endl << *free_dofs << endl;
@@ -644,194 +810,37 @@ lot of new non-zero entries in the matrix!\n" << endl;
       }
     else
       {
-        // tcolmutex.Start();
-      Array<MyMutex> locks(GetNDof());
-      // tcolmutex.Stop();
-      
-      for (auto vb : { VOL, BND, BBND, BBBND })
-      {
-        /*
-        tcol.Start();
-        Array<int> col(ma->GetNE(vb));
-        col = -1;
-
-        int maxcolor = 0;
-        
-        int basecol = 0;
-        Array<unsigned int> mask(GetNDof());
-
-        size_t cnt = 0, found = 0;
-        for (ElementId el : Elements(vb)) { cnt++; (void)el; } // no warning 
-
-        do
-          {
-            mask = 0;
-
-            Array<DofId> dofs;
-            // for (auto el : Elements(vb))
-            for (auto el : ma->Elements(vb))
-              {
-                if (!DefinedOn(el)) continue;
-                if (col[el.Nr()] >= 0) continue;
-
-                unsigned check = 0;
-                GetDofNrs(el, dofs);
-                for (auto d : dofs) // el.GetDofs())
-                  if (d != -1) check |= mask[d];
-
-                if (check != UINT_MAX) // 0xFFFFFFFF)
-                  {
-                    found++;
-                    unsigned checkbit = 1;
-                    int color = basecol;
-                    while (check & checkbit)
-                      {
-                        color++;
-                        checkbit *= 2;
-                      }
-
-                    col[el.Nr()] = color;
-                    if (color > maxcolor) maxcolor = color;
-
-                    if (HasAtomicDofs())
-                      {
-                        for (auto d : dofs) // el.GetDofs())
-                          if (d != -1 && !IsAtomicDof(d)) mask[d] |= checkbit;
-                      }
-                    else
-                      {
-                        for (auto d : dofs) // el.GetDofs())
-                          if (d != -1) mask[d] |= checkbit;
-                      }
-                  }
-              }
-            
-            basecol += 8*sizeof(unsigned int); // 32;
-          }
-        while (found < cnt);
-
-        tcol.Stop();
-
-        Array<int> cntcol(maxcolor+1);
-        cntcol = 0;
-
-        for (ElementId el : Elements(vb))
-          cntcol[col[el.Nr()]]++;
-        
-        Table<int> & coloring = element_coloring[vb];
-        coloring = Table<int> (cntcol);
-
-	cntcol = 0;
-        for (ElementId el : Elements(vb))
-          coloring[col[el.Nr()]][cntcol[col[el.Nr()]]++] = el.Nr();
-        */
-
-
-
-        // tcol.Start();
-        Array<int> col(ma->GetNE(vb));
-        col = -1;
-
-        int maxcolor = 0;
-        
-        int basecol = 0;
-        Array<unsigned int> mask(GetNDof());
-
-        atomic<int> found(0);
-        size_t cnt = 0;
-        for (ElementId el : Elements(vb)) { cnt++; (void)el; } // no warning 
-
-        while (found < cnt)
+        static Timer tcol ("FESpace::FinalizeUpdate - coloring");
+        RegionTimer regcol(tcol);
+        for (auto vb : { VOL, BND, BBND, BBBND })
           {
-            // mask = 0   | tasks;
-
-            ParallelForRange
-              (mask.Size(),
-               [&] (IntRange myrange) { mask[myrange] = 0; });
-
-            size_t ne = ma->GetNE(vb);
-
-            ParallelForRange
-              (ne, [&] (IntRange myrange)
+            bool atomic_dofs = HasAtomicDofs();
+            Array<int> col = ParallelColoring
+              (ma->GetNE(vb), GetNDof(),
+               [&] (size_t nr, Array<DofId> & dofs)
                {
-                 Array<DofId> dofs;
-                 size_t myfound = 0;
-                 
-                 for (size_t nr : myrange)
-                   {
-                     ElementId el = { vb, nr };
-                     if (!DefinedOn(el)) continue;
-                     if (col[el.Nr()] >= 0) continue;
-                     
-                     unsigned check = 0;
-                     GetDofNrs(el, dofs);
-                     
-                     if (HasAtomicDofs())
-                       {
-                         for (int i = dofs.Size()-1; i >= 0; i--)
-                           if (!IsRegularDof(dofs[i]) || IsAtomicDof(dofs[i])) dofs.DeleteElement(i);
-                       }
-                     else
-                       for (int i = dofs.Size()-1; i >= 0; i--)
-                         if (!IsRegularDof(dofs[i])) dofs.DeleteElement(i);
-                     QuickSort (dofs);   // sort to avoid dead-locks
-                     
-                     for (auto d : dofs) 
-                       locks[d].lock();
-                     
-                     for (auto d : dofs) 
-                       check |= mask[d];
-                     
-                     if (check != UINT_MAX) // 0xFFFFFFFF)
-                       {
-                         myfound++;
-                         unsigned checkbit = 1;
-                         int color = basecol;
-                         while (check & checkbit)
-                           {
-                             color++;
-                             checkbit *= 2;
-                           }
-                         
-                         col[el.Nr()] = color;
-                         if (color > maxcolor) maxcolor = color;
-                         
-                         for (auto d : dofs) // el.GetDofs())
-                           mask[d] |= checkbit;
-                       }
-                     
-                     for (auto d : dofs) 
-                       locks[d].unlock();
-                   }
-                 found += myfound;
+                 ElementId el(vb, nr);
+                 if (!DefinedOn(el)) return false;
+                 GetDofNrs(el, dofs);
+                 for (int i = dofs.Size()-1; i >= 0; i--)
+                   if (!IsRegularDof(dofs[i]) || (atomic_dofs && IsAtomicDof(dofs[i])))
+                     dofs.DeleteElement(i);
+                 SortUnique (dofs);
+                 return true;
                });
-                 
-            basecol += 8*sizeof(unsigned int); // 32;
-          }
-
-        // tcol.Stop();
 
-        Array<int> cntcol(maxcolor+1);
-        cntcol = 0;
-
-        for (ElementId el : Elements(vb))
-          cntcol[col[el.Nr()]]++;
-        
-        Table<int> & coloring = element_coloring[vb];
-        coloring = Table<int> (cntcol);
+            element_coloring[vb] = ColoringTable (col);
 
-	cntcol = 0;
-        for (ElementId el : Elements(vb))
-          coloring[col[el.Nr()]][cntcol[col[el.Nr()]]++] = el.Nr();
-        
-        if (print)
-          *testout << "needed " << maxcolor+1 << " colors" 
-                   << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
-      }
+            if (print)
+              *testout << "needed " << element_coloring[vb].Size() << " colors"
+                       << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
+          }
       }
     
     // invalidate facet_coloring
     facet_coloring = Table<int>();
+    facet_neighbours.SetSize0();
+    facet_batches.SetSize0();
        
     level_updated = ma->GetNLevels();
     if (timing) Timing();
@@ -843,90 +852,145 @@ lot of new non-zero entries in the matrix!\n" << endl;
   {
     if (facet_coloring.Size()) return facet_coloring;
 
-    size_t nf = ma->GetNFacets();
-    Array<int> col(nf);
-    col = -1;
-    
-    int maxcolor = 0;
-    int basecol = 0;
-    Array<unsigned int> mask(GetNDof());
+    static Timer t("FESpace::FacetColoring"); RegionTimer reg(t);
+    Array<int> col = ParallelColoring
+      (ma->GetNFacets(), GetNDof(),
+       [&] (size_t f, Array<DofId> & dofs)
+       {
+         ArrayMem<int,4> elnums, elnums_per;
+         Array<DofId> dofs1;
+         ma->GetFacetElements(f,elnums);
+         dofs.SetSize0();
+
+         if (elnums.Size() == 1)
+           {
+             size_t f2 = ma->GetPeriodicFacet(f);
+             if (f2 != f) // color both, left and right facet
+               {
+                 ma->GetFacetElements (f2, elnums_per);
+                 // if the facet is identified across subdomain
+                 // boundary, we only have the surface element
+                 // and not the other volume element!
+                 // that case does not impact coloring
+                 if (elnums_per.Size())
+                   elnums.Append(elnums_per[0]);
+               }
+           }
+         for (auto el : elnums)
+           {
+             GetDofNrs(ElementId(VOL, el), dofs1);
+             for (auto d : dofs1)
+               if (IsRegularDof(d)) dofs.Append(d);
+           }
+         SortUnique (dofs);
+         return true;
+       });
 
-    size_t cnt = nf, found = 0;
-    Array<DofId> dofs, dofs1;
-    Array<int> elnums, elnums_per;
-    
-    do
+    const_cast<Table<int>&> (facet_coloring) = ColoringTable (col);
+
+    // neighbours of interior facets, looked up once instead of in every DG apply
+    auto & neighbours = const_cast<Array<FacetNeighbours>&> (facet_neighbours);
+    neighbours.SetSize (ma->GetNFacets());
+    ParallelFor (neighbours.Size(), [&] (size_t f)
       {
-        mask = 0;
-        for (size_t f = 0; f < nf; f++)
+        ArrayMem<int,4> elnums;
+        FacetNeighbours nb;
+        ma->GetFacetElements (f, elnums);
+        if (elnums.Size() >= 1)
           {
-            if (col[f] >= 0) continue;
-            
-            ma->GetFacetElements(f,elnums);
-            dofs.SetSize0();
+            nb.el1 = elnums[0];
+            nb.facnr1 = ma->GetElFacets(ElementId(VOL, nb.el1)).Pos(f);
+          }
+        if (elnums.Size() == 2)
+          {
+            nb.el2 = elnums[1];
+            nb.facnr2 = ma->GetElFacets(ElementId(VOL, nb.el2)).Pos(f);
+          }
+        neighbours[f] = nb;
+      });
 
-            if (elnums.Size() == 1)
-              {
-                size_t f2 = ma->GetPeriodicFacet(f);
-                // if (f2 < f) continue;
-                if (f2 != f) // color both, left and right facet
-                  {
-                    ma->GetFacetElements (f2, elnums_per);
-		    // if the facet is identified across subdomain
-		    // boundary, we only have the surface element
-		    // and not the other volume element!
-		    // that case does not impact coloring
-		    if (elnums_per.Size())
-		      elnums.Append(elnums_per[0]);
-                  }
-              }
-            for (auto el : elnums)
-              {
-                GetDofNrs(ElementId(VOL, el), dofs1);
-                dofs += dofs1;
-              }
-            
-            unsigned check = 0;
-            for (auto d : dofs)
-              if (IsRegularDof(d)) check |= mask[d];
-            
-            if (check != UINT_MAX) // 0xFFFFFFFF)
+    // class of each element: facets between elements of the same classes
+    // and with the same local facet numbers are applied in one batch
+    Array<int> elclass(ma->GetNE(VOL));
+    {
+      Array<tuple<int,int,int,int,int>> elkeys(ma->GetNE(VOL));
+      LocalHeap lh (10*1000*1000, "FESpace - facet batches");
+      ParallelForRange (IntRange(ma->GetNE(VOL)), [&] (IntRange r)
+        {
+          LocalHeap &clh = lh, lh = clh.Split();
+          for (auto i : r)
+            {
+              HeapReset hr(lh);
+              ElementId ei(VOL, i);
+              if (!DefinedOn(ei))
+                {
+                  elkeys[i] = make_tuple (-1, 0, 0, 0, 0);
+                  continue;
+                }
+              const FiniteElement & fel = GetFE (ei, lh);
+              // shapes and facet rules depend on the vertex numbers
+              // only through their relative ordering
+              auto vnums = ma->GetElVertices (ei);
+              int vorder = 0;
+              for (auto v : vnums)
+                {
+                  int rank = 0;
+                  for (auto w : vnums)
+                    if (w < v) rank++;
+                  vorder = 8*vorder + rank;
+                }
+              elkeys[i] = make_tuple (int(ma->GetElType(ei)), ma->GetElIndex(ei),
+                                      fel.Order(), int(fel.GetNDof()), vorder);
+            }
+        });
+
+      std::map<tuple<int,int,int,int,int>, int> classes;
+      for (auto i : Range(elkeys))
+        elclass[i] = (get<0>(elkeys[i]) == -1) ? -1 :
+          classes.emplace (elkeys[i], classes.size()).first->second;
+    }
+
+    constexpr int max_batchsize = 64;  // facets of one color are shared among tasks by batches
+    auto & batches = const_cast<Array<Table<int>>&> (facet_batches);
+    batches.SetSize (facet_coloring.Size());
+    ParallelFor (facet_coloring.Size(), [&] (size_t col)
+      {
+        FlatArray<int> colfacets = facet_coloring[col];
+        Array<tuple<int,int,int,int>> keys(colfacets.Size());
+        Array<int> order(colfacets.Size());
+        for (auto i : Range(colfacets))
+          {
+            auto & nb = neighbours[colfacets[i]];
+            bool interior = nb.el2 != -1 && elclass[nb.el1] != -1 && elclass[nb.el2] != -1;
+            if (interior)
+              keys[i] = make_tuple (elclass[nb.el1], elclass[nb.el2], nb.facnr1, nb.facnr2);
+            else
+              keys[i] = make_tuple (-1, colfacets[i], 0, 0);    // a batch of its own
+            order[i] = i;
+          }
+        QuickSortI (keys, order);
+
+        TableCreator<int> creator;
+        for ( ; !creator.Done(); creator++)
+          {
+            int nr = -1, cnt = 0;
+            for (auto i : Range(order))
               {
-                found++;
-                unsigned checkbit = 1;
-                int color = basecol;
-                while (check & checkbit)
+                if (i == 0 || get<0>(keys[order[i]]) == -1 ||
+                    keys[order[i]] != keys[order[i-1]] || cnt == max_batchsize)
                   {
-                    color++;
-                    checkbit *= 2;
+                    nr++;
+                    cnt = 0;
                   }
-                
-                col[f] = color;
-                if (color > maxcolor) maxcolor = color;
-		
-                for (auto d : dofs)
-                  if (IsRegularDof(d)) mask[d] |= checkbit;
+                creator.Add (nr, colfacets[order[i]]);
+                cnt++;
               }
           }
-        
-        basecol += 8*sizeof(unsigned int); // 32;
-      }
-    while (found < cnt);
-
-    Array<int> cntcol(maxcolor+1);
-    cntcol = 0;
-    
-    for (auto f : Range(nf))
-      cntcol[col[f]]++;
-    
-    const_cast<Table<int>&> (facet_coloring) = Table<int> (cntcol);
-    
-    cntcol = 0;
-    for (auto f : Range(nf))          
-      facet_coloring[col[f]][cntcol[col[f]]++] = f;
+        batches[col] = creator.MoveTable();
+      });
 
     if (print)
-      *testout << "needed " << maxcolor+1 << " colors for facet-coloring" << endl;
+      *testout << "needed " << facet_coloring.Size() << " colors for facet-coloring" << endl;
 
     return facet_coloring;
   }
@@ -1799,6 +1863,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
 			const function<void(FESpace::Element,LocalHeap&)> & func)
   {
     static mutex copyex_mutex;
+    static Timer tcol("IterateElements - color");
     const Table<int> & element_coloring = fes.ElementColoring(vb);
     
     if (task_manager)
@@ -1810,6 +1875,8 @@ lot of new non-zero entries in the matrix!\n" << endl;
             task_manager -> CreateJob
               ( [&] (const TaskInfo & ti) 
                 {
+                  // per thread share of the color, shows load imbalance
+                  TraceRegion tr(tcol);
                   LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
                   ArrayMem<int,100> temp_dnums;
 
@@ -213,6 +213,16 @@ ANY                  1 1 1 1 | 15
     
     Table<int> element_coloring[4]; 
     Table<int> facet_coloring;  // elements on facet in own colors (DG)
+  public:
+    /// neighbour elements of a facet, el2 = -1 for boundary and periodic facets (DG)
+    struct FacetNeighbours
+    {
+      int el1 = -1, el2 = -1;
+      int facnr1 = -1, facnr2 = -1;
+    };
+  protected:
+    Array<FacetNeighbours> facet_neighbours;
+    Array<Table<int>> facet_batches;
     Array<COUPLING_TYPE> ctofdof;
 
     shared_ptr<ParallelDofs> paralleldofs;
@@ -273,6 +283,15 @@ ANY                  1 1 1 1 | 15
     { return element_coloring[vb]; }
 
     const Table<int> & FacetColoring() const;
+    /// neighbours of all facets, built together with the FacetColoring
+    FlatArray<FacetNeighbours> GetFacetNeighbours() const
+    { FacetColoring(); return facet_neighbours; }
+    /// facets of each color in batches: the facets of a batch with more than
+    /// one facet are interior facets, their neighbour elements agree in type,
+    /// material index, order, ndof, relative vertex ordering and local facet
+    /// number, so they share facet integration rules and shape functions
+    FlatArray<Table<int>> GetFacetBatches() const
+    { FacetColoring(); return facet_batches; }
     
     /// print report to stream
     virtual void PrintReport (ostream & ost) const override;
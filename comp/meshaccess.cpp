@@ -24,6 +24,141 @@ namespace ngcomp
 
 
   template <int DIMS, int DIMR, typename BASE> class ALE_ElementTransformation;
+
+
+  /*
+    Mapped points and Jacobians of SIMD integration rules per element.
+    Entries of an element are a singly linked list, new entries are
+    prepended lock-free, such that lookup needs no locking. The key is
+    the set of reference points, since integration rules are often
+    allocated on the LocalHeap. A cache is never cleared while in use:
+    MeshAccess replaces it by a new one, threads still working with the
+    old cache keep it alive by their shared_ptr.
+  */
+  class GeometryCache
+  {
+    struct Entry
+    {
+      size_t nip;
+      Array<SIMD<double>> refpts;   // DIMS coordinates per point
+      Array<SIMD<double>> values;   // point (DIMR), Jacobian (DIMR*DIMS) per point
+      Entry * next = nullptr;
+    };
+
+    Array<atomic<Entry*>> entries[4];
+    size_t budget;
+    atomic<size_t> memory{0};
+
+    template <int DIMS>
+    static bool SameRule (const Entry & entry, const SIMD_IntegrationRule & ir)
+    {
+      if (entry.nip != ir.Size()) return false;
+      for (size_t i = 0, ii = 0; i < ir.Size(); i++)
+        for (int j = 0; j < DIMS; j++, ii++)
+          if (memcmp (&entry.refpts[ii], &ir[i](j), sizeof(SIMD<double>)) != 0)
+            return false;
+      return true;
+    }
+    
+  public:
+    GeometryCache (size_t abudget) : budget(abudget) { ; }
+    GeometryCache (const GeometryCache &) = delete;
+    ~GeometryCache () { Clear(); }
+
+    void Clear ()
+    {
+      for (auto vb : { VOL, BND, BBND, BBBND })
+        {
+          for (auto & head : entries[vb])
+            {
+              Entry * e = head.load();
+              while (e)
+                {
+                  Entry * next = e->next;
+                  delete e;
+                  e = next;
+                }
+            }
+          entries[vb].SetSize0();
+        }
+      memory = 0;
+    }
+
+    void SetSize (VorB vb, size_t ne)
+    {
+      if (entries[vb].Size() == ne) return;
+      Array<atomic<Entry*>> hentries(ne);
+      for (auto & head : hentries) head = nullptr;
+      entries[vb].Swap (hentries);
+    }
+
+    size_t GetMemory () const { return memory; }
+    size_t GetBudget () const { return budget; }
+    
+    template <int DIMS, int DIMR>
+    bool Get (ElementId ei, const SIMD_IntegrationRule & ir,
+              SIMD_MappedIntegrationRule<DIMS,DIMR> & mir) const
+    {
+      auto & list = entries[ei.VB()];
+      if (ei.Nr() >= list.Size()) return false;
+      for (Entry * e = list[ei.Nr()].load(); e; e = e->next)
+        if (SameRule<DIMS> (*e, ir))
+          {
+            size_t ii = 0;
+            for (size_t i = 0; i < ir.Size(); i++)
+              {
+                auto & mip = mir[i];
+                for (int j = 0; j < DIMR; j++)
+                  mip.Point()(j) = e->values[ii++];
+                for (int j = 0; j < DIMR; j++)
+                  for (int k = 0; k < DIMS; k++)
+                    mip.Jacobian()(j,k) = e->values[ii++];
+              }
+            return true;
+          }
+      return false;
+    }
+
+    template <int DIMS, int DIMR>
+    void Set (ElementId ei, const SIMD_IntegrationRule & ir,
+              const SIMD_MappedIntegrationRule<DIMS,DIMR> & mir)
+    {
+      auto & list = entries[ei.VB()];
+      if (ei.Nr() >= list.Size()) return;
+      
+      size_t entrymem = sizeof(Entry) + ir.Size() * (DIMS+DIMR+DIMR*DIMS) * sizeof(SIMD<double>);
+      // reserve first, other threads may fill the cache concurrently
+      if (memory.fetch_add (entrymem) + entrymem > budget)
+        {
+          memory.fetch_sub (entrymem);
+          return;
+        }
+
+      Entry * e = new Entry;
+      e->nip = ir.Size();
+      e->refpts.SetSize (ir.Size()*DIMS);
+      e->values.SetSize (ir.Size()*(DIMR+DIMR*DIMS));
+      size_t ii = 0, jj = 0;
+      for (size_t i = 0; i < ir.Size(); i++)
+        {
+          for (int j = 0; j < DIMS; j++)
+            e->refpts[jj++] = ir[i](j);
+          auto & mip = mir[i];
+          for (int j = 0; j < DIMR; j++)
+            e->values[ii++] = mip.Point()(j);
+          for (int j = 0; j < DIMR; j++)
+            for (int k = 0; k < DIMS; k++)
+              e->values[ii++] = mip.Jacobian()(j,k);
+        }
+
+      auto & head = list[ei.Nr()];
+      Entry * old = head.load();
+      do
+        e->next = old;
+      while (!head.compare_exchange_weak (old, e));
+    }
+  };
+  
   
   
   string Ngs_Element::defaultstring = "default";
@@ -208,12 +343,18 @@ namespace ngcomp
       // static Timer t("eltrans::multipointjacobian"); RegionTimer reg(t);
       SIMD_MappedIntegrationRule<DIMS,DIMR> & mir = 
 	static_cast<SIMD_MappedIntegrationRule<DIMS,DIMR> &> (bmir);
-      
-      mesh->mesh.MultiElementTransformation <DIMS,DIMR>
-        (elnr, ir.Size(),
-         &ir[0](0), ir.Size()>1 ? &ir[1](0)-&ir[0](0) : 0,
-         &mir[0].Point()(0), ir.Size()>1 ? &mir[1].Point()(0)-&mir[0].Point()(0) : 0,
-         &mir[0].Jacobian()(0,0), ir.Size()>1 ? &mir[1].Jacobian()(0,0)-&mir[0].Jacobian()(0,0) : 0);
+
+      auto cache = mesh->GetGeometryCache();
+      if (!cache || !cache->Get<DIMS,DIMR> (GetElementId(), ir, mir))
+        {
+          mesh->mesh.MultiElementTransformation <DIMS,DIMR>
+            (elnr, ir.Size(),
+             &ir[0](0), ir.Size()>1 ? &ir[1](0)-&ir[0](0) : 0,
+             &mir[0].Point()(0), ir.Size()>1 ? &mir[1].Point()(0)-&mir[0].Point()(0) : 0,
+             &mir[0].Jacobian()(0,0), ir.Size()>1 ? &mir[1].Jacobian()(0,0)-&mir[0].Jacobian()(0,0) : 0);
+          if (cache)
+            cache->Set<DIMS,DIMR> (GetElementId(), ir, mir);
+        }
       
       for (int i = 0; i < ir.Size(); i++)
         mir[i].Compute();
@@ -969,6 +1110,8 @@ namespace ngcomp
     nnodes[NT_ELEMENT] = nnodes[StdNodeType (NT_ELEMENT, dim)];
     nnodes[NT_FACET] = nnodes[StdNodeType (NT_FACET, dim)];
 
+    ClearGeometryCache();
+
     for (auto & p : trafo_jumptable) p = nullptr;
     Iterate<4> ([&](auto DIM)
                 {
@@ -1579,6 +1722,46 @@ namespace ngcomp
         throw Exception ("Mesh::SetDeformation needs a GridFunction with dim="+ToString(dim));
       
     deformation = def;
+    ClearGeometryCache();
+  }
+
+  static shared_ptr<GeometryCache> MakeGeometryCache (const MeshAccess & ma, size_t memory_budget)
+  {
+    auto cache = make_shared<GeometryCache> (memory_budget);
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      cache->SetSize (vb, ma.GetNE(vb));
+    return cache;
+  }
+
+  void MeshAccess :: EnableGeometryCache (size_t memory_budget)
+  {
+    atomic_store (&geometry_cache, MakeGeometryCache (*this, memory_budget));
+  }
+
+  void MeshAccess :: DisableGeometryCache ()
+  {
+    atomic_store (&geometry_cache, shared_ptr<GeometryCache>());
+  }
+
+  void MeshAccess :: ClearGeometryCache () const
+  {
+    // replaced, not cleared: other threads may still read the old cache.
+    // If the cache was disabled or replaced meanwhile, leave it.
+    auto cache = GetGeometryCache();
+    if (!cache) return;
+    atomic_compare_exchange_strong (&geometry_cache, &cache,
+                                    MakeGeometryCache (*this, cache->GetBudget()));
+  }
+
+  shared_ptr<GeometryCache> MeshAccess :: GetGeometryCache () const
+  {
+    return atomic_load (&geometry_cache);
+  }
+
+  size_t MeshAccess :: GetGeometryCacheMemory () const
+  {
+    auto cache = GetGeometryCache();
+    return cache ? cache->GetMemory() : 0;
   }
   
   void MeshAccess :: SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr)
@@ -2121,6 +2304,7 @@ namespace ngcomp
   void MeshAccess :: Curve (int order)
   {
     mesh.Curve(order);
+    ClearGeometryCache();
   } 
   
   int MeshAccess :: GetCurveOrder ()
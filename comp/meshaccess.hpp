@@ -193,6 +193,7 @@ namespace ngcomp
   */
 
   class GridFunction;
+  class GeometryCache;
 
   class NGS_DLL_HEADER MeshAccess : public BaseStatusHandler, public enable_shared_from_this_virtual<MeshAccess>
   {
@@ -239,6 +240,10 @@ namespace ngcomp
     /// for ALE
     shared_ptr<GridFunction> deformation;  
 
+    /// mapped SIMD integration rules of curved elements (optional),
+    /// accessed with atomic_load/atomic_store only
+    mutable shared_ptr<GeometryCache> geometry_cache;
+
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
     
@@ -692,6 +697,19 @@ namespace ngcomp
       return deformation;
     }
 
+    /**
+       Store mapped points and Jacobians of curved elements for 
+       SIMD integration rules, such that repeated assembling/applying 
+       skips the evaluation of the curved geometry. 
+       Memory budget in bytes. The cache is cleared when the mesh changes.
+    */
+    void EnableGeometryCache (size_t memory_budget = 512*1024*1024);
+    void DisableGeometryCache ();
+    void ClearGeometryCache () const;
+    /// the current cache, kept alive by the caller while in use
+    shared_ptr<GeometryCache> GetGeometryCache () const;
+    size_t GetGeometryCacheMemory () const;
+
     void SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr);
     void UnSetPML (int _domnr);
 
@@ -0,0 +1,372 @@
+/**********************************************************************/
+/* File:   pmultigrid.cpp                                             */
+/**********************************************************************/
+
+/*
+   Multigrid in the polynomial order
+*/
+
+#include <comp.hpp>
+#include <h1amg.hpp>
+
+namespace ngcomp
+{
+
+  // a clean 0/+-1 copy of the embedding if it is an injection, nullptr otherwise
+  static shared_ptr<SparseMatrix<double>> Injection (const SparseMatrixTM<double> & emb)
+  {
+    static Timer t("PMultigrid - injection"); RegionTimer rt(t);
+    constexpr double tol = 1e-8;
+    size_t n = emb.Height();
+
+    Array<int> col(n);
+    Array<double> sign(n);
+    Array<int> hits(emb.Width());
+    hits = 0;
+    atomic<bool> injection(true);
+
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   col[i] = -1;
+                   auto cols = emb.GetRowIndices(i);
+                   auto vals = emb.GetRowValues(i);
+                   for (auto j : Range(cols))
+                     {
+                       double v = vals[j];
+                       if (fabs(v) < tol) continue;
+                       if (col[i] != -1 || fabs(fabs(v)-1) > tol)
+                         {
+                           injection = false;
+                           return;
+                         }
+                       col[i] = cols[j];
+                       sign[i] = v > 0 ? 1 : -1;
+                     }
+                   if (col[i] != -1)
+                     AsAtomic(hits[col[i]])++;
+                 });
+
+    if (!injection) return nullptr;
+    for (auto h : hits)
+      if (h > 1) return nullptr;
+
+    Array<int> nne(n);
+    for (auto i : Range(n))
+      nne[i] = (col[i] != -1) ? 1 : 0;
+    auto inj = make_shared<SparseMatrix<double>> (nne, emb.Width());
+    for (auto i : Range(n))
+      if (col[i] != -1)
+        (*inj)(i, col[i]) = sign[i];
+    return inj;
+  }
+
+
+  // H1-AMG from the matrix graph: edge weights -a_ij, vertex weights the row sums
+  static shared_ptr<BaseMatrix> MatrixH1AMG (shared_ptr<SparseMatrixTM<double>> mat,
+                                             shared_ptr<BitArray> freedofs)
+  {
+    bool symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double,double>> (mat) != nullptr;
+    size_t n = mat->Height();
+
+    Array<INT<2>> e2v;
+    Array<double> edge_weights;
+    Array<double> vertex_weights(n);
+    vertex_weights = 0.0;
+
+    for (auto i : Range(n))
+      {
+        auto cols = mat->GetRowIndices(i);
+        auto vals = mat->GetRowValues(i);
+        for (auto j : Range(cols))
+          {
+            int c = cols[j];
+            vertex_weights[i] += vals[j];
+            if (c == int(i)) continue;
+            if (symmetric) vertex_weights[c] += vals[j];
+            if (c < int(i) && vals[j] < 0)
+              {
+                e2v.Append (INT<2>(c, i));
+                edge_weights.Append (-vals[j]);
+              }
+          }
+      }
+    for (auto & w : vertex_weights)
+      w = max(w, 0.0);
+
+    return make_shared<H1AMG_Matrix<double>> (mat, freedofs, e2v, edge_weights, vertex_weights, 0);
+  }
+
+
+  PMultigridMatrix ::
+  PMultigridMatrix (shared_ptr<BaseSparseMatrix> mat, shared_ptr<FESpace> fes,
+                    shared_ptr<BitArray> freedofs, bool condense,
+                    const Flags & flags, LocalHeap & lh)
+  {
+    static Timer t("PMultigrid - setup"); RegionTimer rt(t);
+    static Timer tspace("PMultigrid - spaces");
+    static Timer tprol("PMultigrid - embedding");
+    static Timer tcoarse("PMultigrid - coarse matrices");
+    static Timer tsmooth("PMultigrid - smoothers");
+    static Timer tinv("PMultigrid - coarse solver");
+
+    if (fes->IsComplex() || mat->IsComplex())
+      throw Exception ("PMultigrid: complex matrices not supported");
+    if (fes->GetDimension() != 1)
+      throw Exception ("PMultigrid: needs a space with scalar dofs, got dimension " + ToString(fes->GetDimension()));
+    if (!dynamic_pointer_cast<SparseMatrixTM<double>> (mat))
+      throw Exception (string("PMultigrid: needs a real sparse matrix, got ") + typeid(*mat).name());
+
+    int minorder = int(flags.GetNumFlag ("minorder", 1));
+    smoothingsteps = int(flags.GetNumFlag ("smoothingsteps", 1));
+    damping = flags.GetNumFlag ("damping", 0.7);
+    coarsetype = flags.GetStringFlag ("coarsetype", "direct");
+
+    Array<string> smoothers;
+    for (auto & s : flags.GetStringListFlag ("smoothers"))
+      smoothers.Append (s);
+    if (smoothers.Size() == 0)
+      smoothers.Append (flags.GetStringFlag ("smoother", "gs"));
+
+    Flags blockflags = flags;
+    if (condense)
+      blockflags.SetFlag ("eliminate_internal");
+
+    Level finest;
+    finest.order = fes->GetOrder();
+    finest.fes = fes;
+    finest.mat = mat;
+    finest.freedofs = freedofs;
+    finest.res = mat->CreateColVector();
+    levels.Append (std::move(finest));
+
+    for (int order = fes->GetOrder()-1; order >= minorder; order--)
+      {
+        auto & fine = levels.Last();
+        Level lev;
+        lev.order = order;
+
+        {
+          RegionTimer rts(tspace);
+          Flags cflags = fes->GetFlags();
+          cflags.SetFlag ("order", double(order));
+          lev.fes = CreateFESpace (fes->type, fes->GetMeshAccess(), cflags);
+          lev.fes->Update();
+          lev.fes->FinalizeUpdate();
+          lev.freedofs = lev.fes->GetFreeDofs (condense);
+        }
+
+        {
+          RegionTimer rtp(tprol);
+          auto emb = dynamic_pointer_cast<SparseMatrixTM<double>>
+            (ConvertOperator (lev.fes, fine.fes, VOL, lh, nullptr, nullptr, NULL, nullptr, false, false));
+          if (!emb)
+            throw Exception ("PMultigrid: embedding of order " + ToString(order) + " is not a sparse matrix");
+          auto inj = Injection (*emb);
+          lev.injection = inj != nullptr;
+          if (inj) emb = inj;
+          lev.prol = emb;
+          lev.restr = dynamic_pointer_cast<SparseMatrixTM<double>> (emb->CreateTranspose());
+        }
+
+        {
+          RegionTimer rtc(tcoarse);
+          lev.mat = fine.mat->Restrict (*lev.prol);
+        }
+
+        cout << IM(3) << "PMultigrid: order " << order << ", ndof = " << lev.mat->Height()
+             << (lev.injection ? ", sub-matrix" : ", galerkin") << endl;
+
+        lev.x = lev.mat->CreateColVector();
+        lev.b = lev.mat->CreateColVector();
+        lev.res = lev.mat->CreateColVector();
+        levels.Append (std::move(lev));
+      }
+
+    {
+      RegionTimer rts(tsmooth);
+      for (auto l : Range(levels))
+        {
+          auto & lev = levels[l];
+          if (l == levels.Size()-1 && coarsetype != "smoothing")
+            break;
+          lev.smoother = smoothers[min(size_t(l), smoothers.Size()-1)];
+          if (lev.smoother == "jacobi" || lev.smoother == "gs")
+            lev.jacobi = lev.mat->CreateJacobiPrecond (lev.freedofs);
+          else if (lev.smoother == "block")
+            lev.blockjacobi = lev.mat->CreateBlockJacobiPrecond
+              (lev.fes->CreateSmoothingBlocks (blockflags), 0, true, lev.freedofs);
+          else
+            throw Exception ("PMultigrid: unknown smoother '" + lev.smoother +
+                             "', available are jacobi, gs, block");
+        }
+    }
+
+    RegionTimer rti(tinv);
+    auto & coarse = levels.Last();
+    if (coarsetype == "direct")
+      {
+        coarse.mat->SetInverseType (flags.GetStringFlag ("coarseinverse", GetInverseName (default_inversetype)));
+        coarse_inverse = coarse.mat->InverseMatrix (coarse.freedofs);
+      }
+    else if (coarsetype == "h1amg")
+      {
+        if (!dynamic_pointer_cast<H1HighOrderFESpace> (coarse.fes) || coarse.order != 1)
+          throw Exception ("PMultigrid: coarsetype h1amg needs an H1 space with minorder 1");
+        coarse_inverse = MatrixH1AMG (dynamic_pointer_cast<SparseMatrixTM<double>> (coarse.mat), coarse.freedofs);
+      }
+    else if (coarsetype != "smoothing")
+      throw Exception ("PMultigrid: unknown coarsetype '" + coarsetype +
+                       "', available are direct, h1amg, smoothing");
+  }
+
+
+  void PMultigridMatrix :: Smooth (const Level & lev, BaseVector & x, const BaseVector & b, bool back) const
+  {
+    if (lev.blockjacobi)
+      {
+        if (back)
+          lev.blockjacobi->GSSmoothBack (x, b, smoothingsteps);
+        else
+          lev.blockjacobi->GSSmooth (x, b, smoothingsteps);
+      }
+    else if (lev.smoother == "gs")
+      for (int i = 0; i < smoothingsteps; i++)
+        {
+          if (back)
+            lev.jacobi->GSSmoothBack (x, b);
+          else
+            lev.jacobi->GSSmooth (x, b);
+        }
+    else
+      for (int i = 0; i < smoothingsteps; i++)
+        {
+          *lev.res = b - *lev.mat * x;
+          lev.jacobi->MultAdd (damping, *lev.res, x);
+        }
+  }
+
+
+  void PMultigridMatrix :: Cycle (int l, BaseVector & x, const BaseVector & b) const
+  {
+    auto & lev = levels[l];
+    x = 0.0;
+
+    if (l == int(levels.Size())-1)
+      {
+        if (coarse_inverse)
+          coarse_inverse->Mult (b, x);
+        else
+          {
+            Smooth (lev, x, b, false);
+            Smooth (lev, x, b, true);
+          }
+      }
+    else
+      {
+        auto & coarse = levels[l+1];
+        Smooth (lev, x, b, false);
+        *lev.res = b - *lev.mat * x;
+        *coarse.b = *coarse.restr * *lev.res;
+        Cycle (l+1, *coarse.x, *coarse.b);
+        x += *coarse.prol * *coarse.x;
+        Smooth (lev, x, b, true);
+      }
+
+    // no correction for Dirichlet (or condensed) dofs
+    auto fx = x.FVDouble();
+    auto & free = *lev.freedofs;
+    ParallelForRange (fx.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          if (!free.Test(i)) fx(i) = 0.0;
+                      });
+  }
+
+
+  void PMultigridMatrix :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t("PMultigrid - mult"); RegionTimer rt(t);
+    Cycle (0, x, b);
+  }
+
+
+  void PMultigridMatrix :: MultAdd (double s, const BaseVector & b, BaseVector & x) const
+  {
+    auto hx = x.CreateVector();
+    Mult (b, hx);
+    x.Add (s, hx);
+  }
+
+
+
+  /**
+     Preconditioner wrapper, set up after assembling the bilinear form.
+  */
+  class PMultigridPreconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<PMultigridMatrix> pre;
+
+  public:
+    PMultigridPreconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                              const string aname = "pmultigrid")
+      : Preconditioner (abfa, aflags, aname), bfa(abfa)
+    { ; }
+
+    PMultigridPreconditioner (const PDE & pde, const Flags & aflags, const string & aname)
+      : PMultigridPreconditioner (pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")),
+                                  aflags, aname)
+    { ; }
+
+    virtual void FinalizeLevel (const BaseMatrix * mat) override
+    {
+      timestamp = bfa->GetTimeStamp();
+      auto smat = dynamic_pointer_cast<BaseSparseMatrix> (bfa->GetMatrixPtr());
+      if (!smat)
+        throw Exception ("PMultigrid: needs an assembled sparse matrix");
+
+      bool condense = bfa->UsesEliminateInternal();
+      LocalHeap lh(10*1000*1000, "pmultigrid setup", true);
+      pre = make_shared<PMultigridMatrix> (smat, bfa->GetFESpace(),
+                                           bfa->GetFESpace()->GetFreeDofs(condense),
+                                           condense, flags, lh);
+      if (test) Test();
+    }
+
+    virtual void Update () override
+    {
+      if (GetTimeStamp() < bfa->GetTimeStamp())
+        FinalizeLevel (&bfa->GetMatrix());
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      if (!pre)
+        ThrowPreconditionerNotReady();
+      return *pre;
+    }
+
+    virtual shared_ptr<BaseMatrix> GetMatrixPtr() override
+    {
+      if (!pre)
+        ThrowPreconditionerNotReady();
+      return pre;
+    }
+
+    virtual void CleanUpLevel () override
+    {
+      pre.reset();
+    }
+
+    virtual const char * ClassName() const override
+    { return "p-Multigrid Preconditioner"; }
+  };
+
+
+  static RegisterPreconditioner<PMultigridPreconditioner> initpmg ("pmultigrid");
+}
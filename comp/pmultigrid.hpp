@@ -0,0 +1,96 @@
+#ifndef FILE_PMULTIGRID
+#define FILE_PMULTIGRID
+
+/**********************************************************************/
+/* File:   pmultigrid.hpp                                             */
+/**********************************************************************/
+
+/*
+   Multigrid in the polynomial order
+*/
+
+
+namespace ngcomp
+{
+
+  /**
+     V-cycle over the orders p -> p-1 -> ... -> minorder of a high order space.
+
+     The spaces of lower order are created from the type and flags of the
+     given space. For hierarchical bases the embedding of order q-1 into
+     order q is an injection (one entry +-1 per column), then the coarse
+     matrix P^T A P is a sub-matrix of the assembled matrix and no
+     element matrices are recomputed. Otherwise P is the exact embedding
+     computed by ConvertOperator, and the coarse matrix is the Galerkin
+     product.
+
+     Smoothers (per level, finest first, the last one is repeated):
+       jacobi  damped point Jacobi
+       gs      point Gauss-Seidel, backward in the post-smoothing
+       block   block Gauss-Seidel with the smoothing blocks of the level space
+
+     Coarsest level:
+       direct     sparse factorization (coarseinverse = inverse type)
+       h1amg      H1-AMG built from the matrix graph, order 1 H1 only
+       smoothing  smoother of the coarsest level only
+  */
+  class NGS_DLL_HEADER PMultigridMatrix : public BaseMatrix
+  {
+  public:
+    struct Level
+    {
+      int order;
+      shared_ptr<FESpace> fes;
+      shared_ptr<BaseSparseMatrix> mat;
+      shared_ptr<BitArray> freedofs;
+      /// embedding into the next finer level and its transpose (not on the finest level)
+      shared_ptr<SparseMatrixTM<double>> prol, restr;
+      bool injection = false;
+
+      string smoother;
+      shared_ptr<BaseJacobiPrecond> jacobi;
+      shared_ptr<BaseBlockJacobiPrecond> blockjacobi;
+
+      /// work vectors (not on the finest level x and b are the arguments of Mult)
+      shared_ptr<BaseVector> x, b, res;
+    };
+
+  protected:
+    Array<Level> levels;
+    shared_ptr<BaseMatrix> coarse_inverse;
+    string coarsetype;
+    int smoothingsteps;
+    double damping;
+
+    void Smooth (const Level & lev, BaseVector & x, const BaseVector & b, bool back) const;
+    void Cycle (int l, BaseVector & x, const BaseVector & b) const;
+
+  public:
+    /**
+       mat ... assembled matrix of fes (possibly condensed)
+       freedofs ... free dofs of mat
+       condense ... use free dofs without inner dofs on the coarse levels
+    */
+    PMultigridMatrix (shared_ptr<BaseSparseMatrix> mat, shared_ptr<FESpace> fes,
+                      shared_ptr<BitArray> freedofs, bool condense,
+                      const Flags & flags, LocalHeap & lh);
+
+    int GetNLevels() const { return levels.Size(); }
+    const Level & GetLevel (int l) const { return levels[l]; }
+
+    /// replace the solver of the coarsest level, e.g. by a user preconditioner
+    void SetCoarseInverse (shared_ptr<BaseMatrix> inv) { coarse_inverse = inv; }
+
+    virtual bool IsComplex() const override { return false; }
+    virtual int VHeight() const override { return levels[0].mat->Height(); }
+    virtual int VWidth() const override { return levels[0].mat->Width(); }
+    virtual AutoVector CreateRowVector () const override { return levels[0].mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return levels[0].mat->CreateRowVector(); }
+
+    virtual void Mult (const BaseVector & b, BaseVector & x) const override;
+    virtual void MultAdd (double s, const BaseVector & b, BaseVector & x) const override;
+  };
+
+}
+
+#endif
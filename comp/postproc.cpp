@@ -927,6 +927,352 @@ namespace ngcomp
 
 
 
+  // the integration rules of SetValues on one element: the volume rule,
+  // or the facet rules of the nodes carrying dual shapes
+  template <typename FUNC>
+  static void IterateSetValuesRules (const FESpace & fes, const FiniteElement & fel, VorB vb,
+                                     bool dual, int bonus_intorder, LocalHeap & lh, FUNC func)
+  {
+    if (!dual)
+      {
+        IntegrationRule ir(fel.ElementType(), 2*fel.Order() + bonus_intorder);
+        func (ir);
+        return;
+      }
+
+    auto [nv,ne,nf,nc] = fel.GetNDofVEFC();
+    int nvefc[] = {nv,ne,nf,nc};
+    int meshdim = fes.GetMeshAccess()->GetDimension();
+    for (auto el_vb : fes.GetDualShapeNodes(vb))
+      {
+        if (!nvefc[meshdim-el_vb-vb])
+          continue;
+        Facet2ElementTrafo f2el (fel.ElementType(), el_vb);
+        for (int locfnr : Range(f2el.GetNFacets()))
+          {
+            IntegrationRule irfacet(f2el.FacetType(locfnr), 2 * fel.Order() + bonus_intorder);
+            auto & irvol = f2el(locfnr, irfacet, lh);
+            func (irvol);
+          }
+      }
+  }
+
+  SetValuesInterpolator ::
+  SetValuesInterpolator (shared_ptr<FESpace> afes, VorB avb, const Region * reg,
+                         LocalHeap & clh, bool adual,
+                         optional<shared_ptr<BitArray>> adefinedonelements,
+                         int abonus_intorder)
+    : fes(afes), vb(avb), definedonelements(adefinedonelements),
+      dual(adual), bonus_intorder(abonus_intorder)
+  {
+    if (reg)
+      {
+        vb = reg->VB();
+        domains = make_shared<BitArray> (reg->Mask());
+      }
+    Setup (clh);
+  }
+
+  void SetValuesInterpolator :: Setup (LocalHeap & clh)
+  {
+    static Timer t("SetValuesInterpolator - setup"); RegionTimer r(t);
+
+    auto ma = fes->GetMeshAccess();
+    int dim = fes->GetDimension();
+
+    if (definedonelements.has_value() && definedonelements.value()->Size() != ma->GetNE(vb))
+      throw Exception ("SetValuesInterpolator: definedonelements does not fit the mesh");
+    setup_ndof = fes->GetNDof();
+    setup_ne = ma->GetNE(vb);
+    setup_mesh_timestamp = ma->GetTimeStamp();
+    setup_deformation = ma->GetDeformation().get();
+
+    // the local matrix to invert: mass matrix, or dual matrix for dual = true
+    Array<shared_ptr<BilinearFormIntegrator>> single_bli;
+    if (dual)
+      {
+        if (!fes->GetAdditionalEvaluators().Used("dual"))
+          throw Exception(string("Dual diffop does not exist for ") + fes->GetClassName() + string("!"));
+        if (!fes->GetEvaluator(vb))
+          throw Exception(fes->GetClassName()+string(" does not have an evaluator for ")+ToString(vb)+string("!"));
+
+        auto single_evaluator = fes->GetEvaluator(vb);
+        if (dynamic_pointer_cast<BlockDifferentialOperator>(single_evaluator))
+          single_evaluator = dynamic_pointer_cast<BlockDifferentialOperator>(single_evaluator)->BaseDiffOp();
+        auto trial = make_shared<ProxyFunction>(fes, false, false, single_evaluator,
+                                                nullptr, nullptr, nullptr, nullptr, nullptr);
+
+        diffop = fes->GetAdditionalEvaluators()["dual"];
+        for (VorB avb = VOL; avb < vb; avb++)
+          {
+            diffop = diffop->GetTrace();
+            if (!diffop)
+              throw Exception(fes->GetClassName() + string(" has no dual trace operator for vb = ") +
+                              to_string(avb) + string(" -> ") + to_string(avb + 1) + string("!"));
+          }
+        auto single_dual_evaluator = diffop;
+        if (dynamic_pointer_cast<BlockDifferentialOperator>(diffop))
+          single_dual_evaluator = dynamic_pointer_cast<BlockDifferentialOperator>(diffop)->BaseDiffOp();
+        auto dualproxy = make_shared<ProxyFunction>(fes, true, false, single_dual_evaluator,
+                                                    nullptr, nullptr, nullptr, nullptr, nullptr);
+        for (auto element_vb : fes->GetDualShapeNodes(vb))
+          {
+            shared_ptr<CoefficientFunction> dual_trial;
+            if (dualproxy->Dimension() == 1)
+              dual_trial = dualproxy * trial;
+            else
+              dual_trial = InnerProduct(dualproxy, trial);
+            shared_ptr<BilinearFormIntegrator> bfi = make_shared<SymbolicBilinearFormIntegrator> (dual_trial, vb, element_vb);
+            if (auto block_bfi = dynamic_pointer_cast<BlockBilinearFormIntegrator> (bfi))
+              bfi = block_bfi->BlockPtr();
+            single_bli.Append (bfi);
+          }
+        if (!single_bli.Size())
+          throw Exception("Error in SetValuesInterpolator: No dual shape Integrators!");
+      }
+    else
+      {
+        diffop = fes->GetEvaluator(vb);
+        if (!diffop)
+          throw Exception(fes->GetClassName()+string(" does not have an evaluator for ")+ToString(vb)+string("!"));
+
+        shared_ptr<BilinearFormIntegrator> bli = fes->GetIntegrator(vb);
+        if (bli && dynamic_pointer_cast<BlockBilinearFormIntegrator> (bli))
+          bli = dynamic_pointer_cast<BlockBilinearFormIntegrator> (bli)->BlockPtr();
+        if (!bli)
+          {
+            auto single_evaluator = diffop;
+            if (dynamic_pointer_cast<BlockDifferentialOperator>(single_evaluator))
+              single_evaluator = dynamic_pointer_cast<BlockDifferentialOperator>(single_evaluator)->BaseDiffOp();
+            auto trial = make_shared<ProxyFunction>(fes, false, false, single_evaluator,
+                                                    nullptr, nullptr, nullptr, nullptr, nullptr);
+            auto test  = make_shared<ProxyFunction>(fes, true, false, single_evaluator,
+                                                    nullptr, nullptr, nullptr, nullptr, nullptr);
+            bli = make_shared<SymbolicBilinearFormIntegrator> (InnerProduct(trial,test), vb, VOL);
+          }
+        single_bli.Append (bli);
+      }
+    dimflux = diffop->Dim();
+
+    // sizes of the projection matrices, and dof counts
+    Array<int> sizes(ma->GetNE(vb));
+    sizes = 0;
+    Array<int> cnt(fes->GetNDof());
+    cnt = 0;
+    IterateElements
+      (*fes, vb, clh,
+       [&] (FESpace::Element ei, LocalHeap & lh)
+       {
+         if (!UseElement(ei)) return;
+         const FiniteElement & fel = fes->GetFE (ei, lh);
+         size_t nip = 0;
+         IterateSetValuesRules (*fes, fel, vb, dual, bonus_intorder, lh,
+                                [&] (const IntegrationRule & ir) { nip += ir.Size(); });
+         sizes[ei.Nr()] = fel.GetNDof() * dim * nip * dimflux;
+         for (auto d : ei.GetDofs())
+           if (IsRegularDof(d)) cnt[d]++;
+       });
+
+#ifdef PARALLEL
+    AllReduceDofData (cnt, MPI_SUM, fes->GetParallelDofs());
+#endif
+
+    weights.SetSize (cnt.Size());
+    ParallelFor (cnt.Size(), [&] (size_t i)
+                 { weights[i] = cnt[i] ? 1.0 / cnt[i] : 0.0; });
+
+    proj = Table<double> (sizes);
+    IterateElements
+      (*fes, vb, clh,
+       [&] (FESpace::Element ei, LocalHeap & lh)
+       {
+         if (!UseElement(ei) || proj[ei.Nr()].Size() == 0) return;
+
+         const FiniteElement & fel = fes->GetFE (ei, lh);
+         const ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
+         size_t nd = fel.GetNDof();
+         size_t ndof = nd * dim;
+         size_t nvals = proj[ei.Nr()].Size() / ndof;
+
+         // weighted transposed evaluation, one column per value in an integration point
+         FlatMatrix<> btw(ndof, nvals, lh);
+         size_t offset = 0;
+         IterateSetValuesRules
+           (*fes, fel, vb, dual, bonus_intorder, lh,
+            [&] (const IntegrationRule & ir)
+            {
+              auto & mir = eltrans(ir, lh);
+              FlatMatrix<double,ColMajor> bmat(ir.Size()*dimflux, ndof, lh);
+              diffop->CalcMatrix (fel, mir, bmat, lh);
+              for (size_t i : Range(ir))
+                for (int k : Range(dimflux))
+                  btw.Col(offset+i*dimflux+k) = mir[i].GetWeight() * bmat.Row(i*dimflux+k);
+              offset += ir.Size()*dimflux;
+            });
+
+         // local matrix, inverted once (dual: only if SolveDuality is not available)
+         FlatMatrix<> elmat(nd, lh);
+         bool have_inverse = false;
+         auto get_inverse = [&] ()
+           {
+             if (have_inverse) return;
+             elmat = 0.0;
+             bool symmetric_so_far = true;
+             for (auto sbfi : single_bli)
+               sbfi->CalcElementMatrixAdd (fel, eltrans, elmat, symmetric_so_far, lh);
+             CalcInverse (elmat);
+             have_inverse = true;
+           };
+
+         FlatMatrix<> pmat(ndof, nvals, proj[ei.Nr()].Data());
+         FlatVector<> rhs(ndof, lh), sol(ndof, lh);
+         for (size_t c : Range(nvals))
+           {
+             rhs = btw.Col(c);
+             bool solved = dual;
+             if (dual)
+               for (int j : Range(dim))
+                 solved = fel.SolveDuality (rhs.Slice(j,dim), sol.Slice(j,dim), lh);
+             if (!solved)
+               {
+                 get_inverse();
+                 for (int j : Range(dim))
+                   sol.Slice(j,dim) = elmat * rhs.Slice(j,dim);
+               }
+             pmat.Col(c) = sol;
+           }
+       });
+  }
+
+  void SetValuesInterpolator :: Update (LocalHeap & lh)
+  {
+    auto ma = fes->GetMeshAccess();
+    if (setup_ndof != fes->GetNDof() || setup_ne != ma->GetNE(vb) ||
+        setup_mesh_timestamp != ma->GetTimeStamp() ||
+        setup_deformation != ma->GetDeformation().get())
+      Setup (lh);
+  }
+
+  bool SetValuesInterpolator :: UseElement (const FESpace::Element & ei) const
+  {
+    if (definedonelements.has_value() && !definedonelements.value()->Test(ei.Nr()))
+      return false;
+    if (domains)
+      return domains->Test(ei.GetIndex());
+    if (vb == BND)
+      return fes->IsDirichletBoundary(ei.GetIndex());
+    return true;
+  }
+
+  size_t SetValuesInterpolator :: MemoryUsage () const
+  {
+    size_t nvals = weights.Size();
+    for (size_t i = 0; i < proj.Size(); i++)
+      nvals += proj[i].Size();
+    return nvals * sizeof(double);
+  }
+
+  template <typename SCAL>
+  void SetValuesInterpolator :: T_Set (shared_ptr<CoefficientFunction> coef, GridFunction & u,
+                                       LocalHeap & clh, int mdcomp) const
+  {
+    static Timer t("SetValuesInterpolator::Set"); RegionTimer r(t);
+
+    if (u.GetFESpace() != fes)
+      throw Exception ("SetValuesInterpolator: GridFunction is not on the space of the interpolator");
+    if (coef->Dimension() != dimflux)
+      throw Exception(string("Error in SetValuesInterpolator: gridfunction-dim = ") + ToString(dimflux) +
+                      ", but coefficient-dim = " + ToString(coef->Dimension()));
+
+    auto ma = fes->GetMeshAccess();
+    int dim = fes->GetDimension();
+    auto cachecfs = FindCacheCF (*coef);
+    u.GetVector(mdcomp) = 0.0;
+
+    IterateElements
+      (*fes, vb, clh,
+       [&] (FESpace::Element ei, LocalHeap & lh)
+       {
+         auto projel = proj[ei.Nr()];
+         if (projel.Size() == 0) return;
+
+         const FiniteElement & fel = fes->GetFE (ei, lh);
+         const ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
+         size_t ndof = fel.GetNDof() * dim;
+         size_t nvals = projel.Size() / ndof;
+
+         ProxyUserData ud;
+         const_cast<ElementTransformation&>(eltrans).userdata = &ud;
+
+         FlatVector<SCAL> vals(nvals, lh);
+         size_t offset = 0;
+         IterateSetValuesRules
+           (*fes, fel, vb, dual, bonus_intorder, lh,
+            [&] (const IntegrationRule & ir)
+            {
+              FlatMatrix<SCAL> mvals(ir.Size(), dimflux, &vals(offset));
+              offset += ir.Size()*dimflux;
+              if constexpr (is_same<SCAL,double>::value)
+                if (use_simd && !dual)
+                  {
+                    try
+                      {
+                        SIMD_IntegrationRule simd_ir(ir, lh);
+                        auto & mir = eltrans(simd_ir, lh);
+                        PrecomputeCacheCF (cachecfs, mir, lh);
+                        FlatMatrix<SIMD<double>> simd_vals(dimflux, simd_ir.Size(), lh);
+                        coef->Evaluate (mir, simd_vals);
+                        constexpr size_t SW = SIMD<double>::Size();
+                        for (size_t i : Range(ir))
+                          for (int k : Range(dimflux))
+                            mvals(i,k) = simd_vals(k, i/SW)[i%SW];
+                        return;
+                      }
+                    catch (const ExceptionNOSIMD & e)
+                      {
+                        use_simd = false;
+                        cout << IM(4) << "Warning: switching to std evalution in SetValuesInterpolator since: " << e.What() << endl;
+                      }
+                  }
+              auto & mir = eltrans(ir, lh);
+              PrecomputeCacheCF (cachecfs, mir, lh);
+              coef->Evaluate (mir, mvals);
+            });
+
+         FlatVector<SCAL> elfluxi(ndof, lh), elflux(ndof, lh);
+         elfluxi = FlatMatrix<>(ndof, nvals, projel.Data()) * vals;
+
+         fes->TransformVec (ei, elfluxi, TRANSFORM_SOL_INVERSE);
+         u.GetElementVector (mdcomp, ei.GetDofs(), elflux);
+         elfluxi += elflux;
+         u.SetElementVector (mdcomp, ei.GetDofs(), elfluxi);
+       });
+
+#ifdef PARALLEL
+    u.GetVector(mdcomp).SetParallelStatus(DISTRIBUTED);
+    u.GetVector(mdcomp).Cumulate();
+#endif
+
+    auto fv = u.GetVector(mdcomp).FV<SCAL>();
+    ParallelFor (weights.Size(), [&] (size_t i)
+                 {
+                   for (int j : Range(dim))
+                     fv(i*dim+j) *= weights[i];
+                 });
+  }
+
+  void SetValuesInterpolator :: Set (shared_ptr<CoefficientFunction> coef, GridFunction & u,
+                                     LocalHeap & lh, int mdcomp)
+  {
+    Update (lh);
+    if (fes->IsComplex())
+      T_Set<Complex> (coef, u, lh, mdcomp);
+    else
+      T_Set<double> (coef, u, lh, mdcomp);
+  }
+
+
+
 
   template <class SCAL>
   void CalcError (const S_GridFunction<SCAL> & u,
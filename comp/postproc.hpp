@@ -54,6 +54,67 @@ namespace ngcomp
                   bool dualdiffop = false, bool use_simd = true, int mdcomp=0,
                   optional<shared_ptr<BitArray>> definedonelements = nullopt,
                   int bonus_intorder=0);
+
+
+  /**
+     SetValues for repeated calls with the same space, e.g. for
+     time-dependent Dirichlet data.
+
+     The constructor computes once per element the projection matrix
+     mapping the coefficient values in the integration points to the
+     element dofs (inverse mass or dual matrix times the weighted
+     transposed evaluation), and the averaging weights of the dofs.
+     Set evaluates the coefficient and applies the element matrices.
+
+     The elements are selected as in SetValues: a region, vb = BND for
+     the Dirichlet boundaries, and optionally definedonelements.
+  */
+  class NGS_DLL_HEADER SetValuesInterpolator
+  {
+    shared_ptr<FESpace> fes;
+    VorB vb;
+    shared_ptr<BitArray> domains;   // nullptr .. as SetValues without region
+    optional<shared_ptr<BitArray>> definedonelements;
+    bool dual;
+    int bonus_intorder;
+    shared_ptr<DifferentialOperator> diffop;
+    int dimflux;
+    // per element the (ndof*dim) x (nip*dimflux) projection, row-major, empty if unused
+    Table<double> proj;
+    // 1 / number of elements sharing the dof, 0 for unused dofs
+    Array<double> weights;
+    // switched off by the first element which cannot be evaluated with SIMD
+    mutable atomic<bool> use_simd{true};
+    // state of space and mesh the matrices were computed for
+    size_t setup_ndof = 0;
+    size_t setup_ne = 0;
+    size_t setup_mesh_timestamp = 0;
+    const GridFunction * setup_deformation = nullptr;
+
+  public:
+    SetValuesInterpolator (shared_ptr<FESpace> afes, VorB avb, const Region * reg,
+                           LocalHeap & lh, bool adual = false,
+                           optional<shared_ptr<BitArray>> adefinedonelements = nullopt,
+                           int abonus_intorder = 0);
+
+    shared_ptr<FESpace> GetFESpace() const { return fes; }
+    /// memory of the projection matrices in bytes
+    size_t MemoryUsage() const;
+
+    /// recompute the matrices if the mesh or the space has changed since the setup
+    void Update (LocalHeap & lh);
+    
+    /// calls Update first, so Set works after mesh.Refine() and fes.Update()
+    void Set (shared_ptr<CoefficientFunction> coef, GridFunction & u,
+              LocalHeap & lh, int mdcomp = 0);
+
+  private:
+    void Setup (LocalHeap & lh);
+    bool UseElement (const FESpace::Element & ei) const;
+    template <typename SCAL>
+    void T_Set (shared_ptr<CoefficientFunction> coef, GridFunction & u,
+                LocalHeap & clh, int mdcomp) const;
+  };
   
 
   template <class SCAL>
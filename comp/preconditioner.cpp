@@ -264,6 +264,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev") 
+      {
+        sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	if (!lfconstraint)
@@ -291,6 +295,7 @@ namespace ngcomp
     mgp->SetCoarseSmoothingSteps (int(flags.GetNumFlag ("coarsesmoothingsteps", 1)));
     mgp->SetUpdateAll( flags.GetDefineFlag( "updateall" ) );
     mgp->SetHarmonicExtensionProlongation (flags.GetDefineFlag("he_prolongation"));
+    mgp->SetUseProlongationMatrix (flags.GetDefineFlag("matrixprolongation"));
     MultigridPreconditioner::COARSETYPE ct = MultigridPreconditioner::EXACT_COARSE;
     const string & coarse = flags.GetStringFlag ("coarsetype", "direct");
     if (coarse == "smoothing")
@@ -360,6 +365,10 @@ namespace ngcomp
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev") 
+      {
+        sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	// if (!lfconstraint)
@@ -390,6 +399,7 @@ namespace ngcomp
     mgp->SetCoarseSmoothingSteps (int(flags.GetNumFlag ("coarsesmoothingsteps", 1)));
     mgp->SetUpdateAll( flags.GetDefineFlag( "updateall" ) );
     mgp->SetHarmonicExtensionProlongation (flags.GetDefineFlag("he_prolongation"));    
+    mgp->SetUseProlongationMatrix (flags.GetDefineFlag("matrixprolongation"));
     mgp->SetUpdateAlways(flags.GetDefineFlag("updatealways"));
 
     MultigridPreconditioner::COARSETYPE ct = MultigridPreconditioner::EXACT_COARSE;
@@ -650,6 +660,96 @@ namespace ngcomp
 
 
 
+  // ****************************** SchwarzPreconditioner **************************
+
+
+  /**
+     Two-level overlapping Schwarz, one subdomain per MPI rank, with the
+     minimal overlap of the partition (the dofs shared between ranks).
+     Flags: restricted, coarse (default true), inverse (local solver).
+  */
+  class NGS_DLL_HEADER SchwarzPreconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BaseMatrix> schwarz;
+    string inversetype;
+    bool restricted;
+    bool coarse;
+
+  public:
+    SchwarzPreconditioner (const PDE & pde, const Flags & aflags,
+                           const string aname = "schwarzprecond")
+      : Preconditioner(&pde,aflags,aname)
+    {
+      bfa = pde.GetBilinearForm (flags.GetStringFlag ("bilinearform", NULL));
+      SetFlags();
+    }
+
+    SchwarzPreconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                           const string aname = "schwarzprecond")
+      : Preconditioner(abfa,aflags,aname), bfa(abfa)
+    {
+      SetFlags();
+    }
+
+    void SetFlags ()
+    {
+      inversetype = flags.GetStringFlag("inverse", "sparsecholesky");
+      restricted = flags.GetDefineFlag("restricted");
+      coarse = !flags.GetDefineFlagX("coarse").IsFalse();
+    }
+
+    virtual void FinalizeLevel (const BaseMatrix * mat) override
+    {
+      Update();
+    }
+
+    virtual void Update () override
+    {
+      if (GetTimeStamp() == bfa->GetTimeStamp()) return;
+      timestamp = bfa->GetTimeStamp();
+
+      cout << IM(3) << "Update Schwarz Preconditioner" << endl;
+      shared_ptr<BitArray> freedofs =
+        bfa->GetFESpace()->GetFreeDofs (bfa->UsesEliminateInternal());
+      schwarz = make_shared<ParallelSchwarzPrecond> (bfa->GetMatrixPtr(), freedofs,
+                                                     restricted, coarse, inversetype);
+      GetMemoryTracer().Track(*schwarz, "Schwarz");
+    }
+
+    virtual void CleanUpLevel () override
+    {
+      schwarz = nullptr;
+    }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      if (!schwarz)
+        ThrowPreconditionerNotReady();
+      return *schwarz;
+    }
+
+    virtual shared_ptr<BaseMatrix> GetMatrixPtr() override
+    {
+      if (!schwarz)
+        ThrowPreconditionerNotReady();
+      return schwarz;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const char * ClassName() const override
+    {
+      return "Schwarz Preconditioner";
+    }
+  };
+
+
+
+
   // ****************************** LocalPreconditioner *******************************
 
 
@@ -1346,6 +1446,7 @@ ComplexPreconditioner :: ComplexPreconditioner (PDE * apde, const Flags & aflags
   RegisterPreconditioner<MGPreconditioner> registerMG("multigrid");
   RegisterPreconditioner<DirectPreconditioner> registerDirect("direct");
   RegisterPreconditioner<LocalPreconditioner> registerlocal("local");
+  RegisterPreconditioner<SchwarzPreconditioner> registerschwarz("schwarz");
 
 }
 
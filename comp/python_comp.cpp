@@ -50,6 +50,7 @@ public:
   using NumProc::NumProc;
   virtual void Do (LocalHeap &lh) override
   {
+      py::gil_scoped_acquire agil;
       auto pylh = py::cast(lh, py::return_value_policy::reference);
       try{
           PYBIND11_OVERLOAD_PURE(
@@ -372,7 +373,17 @@ ANY_DOF: Any used dof (LOCAL_DOF or INTERFACE_DOF or WIREBASKET_DOF)
                   {
                     code_uses_tensors = val;
                   }, "Use tensors in code-generation")
-                  
+
+    .def_property("numa_interleave",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return numa_interleave;
+                  },
+                  [] (GlobalDummyVariables&, bool val)
+                  {
+                    numa_interleave = val;
+                  }, "Allocate new vectors interleaved over the NUMA nodes instead of first touch by the using threads")
+
     ;
 
   m.attr("ngsglobals") = py::cast(&globvar);
@@ -748,14 +759,14 @@ kwargs : kwargs
          { 
            self->Update();
            self->FinalizeUpdate();
-         },
+         }, py::call_guard<py::gil_scoped_release>(),
          "update space after mesh-refinement")
      .def("UpdateDofTables", [](shared_ptr<FESpace> self)
          {
            self->UpdateDofTables();
            self->UpdateCouplingDofArray();
            self->FinalizeUpdate();
-         },
+         }, py::call_guard<py::gil_scoped_release>(),
          "update dof-tables after changing polynomial order distribution")
      .def("FinalizeUpdate", [](shared_ptr<FESpace> self)
          { 
@@ -2005,7 +2016,7 @@ active_dofs : BitArray or None
     .def("__str__", [] (GF & self) { return ToString(self); } )
     .def_property_readonly("space", [](GF & self) { return self.GetFESpace(); },
                            "the finite element space")
-    .def("Update", [](GF& self) { self.Update(); },
+    .def("Update", [](GF& self) { self.Update(); }, py::call_guard<py::gil_scoped_release>(),
          "update vector size to finite element space dimension after mesh refinement")
     .def_property_readonly("autoupdate", [] (shared_ptr<GridFunction> self) {return self->DoesAutoUpdate();})
     
@@ -2017,7 +2028,7 @@ active_dofs : BitArray or None
            else
              for (auto d : self.GetVector().FVDouble())
                SaveBin(out, d);
-         },
+         }, py::call_guard<py::gil_scoped_release>(),
          py::arg("filename"), py::arg("parallel")=false, docu_string(R"raw_string(
 Saves the gridfunction into a file.
 
@@ -2040,7 +2051,7 @@ parallel : bool
            else
              for (auto & d : self.GetVector().FVDouble())
                LoadBin(in, d);
-         },
+         }, py::call_guard<py::gil_scoped_release>(),
          py::arg("filename"), py::arg("parallel")=false, docu_string(R"raw_string(       
 Loads a gridfunction from a file.
 
@@ -2542,6 +2553,16 @@ space : ngsolve.FESpace
                      py::arg("keep_internal") = "bool = True\n"
                      "  store harmonic extension and inner inverse matrix from static condensation\n"
                      "  set to False to save memory, and recompute local matrices on demand\n",
+                     py::arg("condense_single") = "bool = False\n"
+                     "  store harmonic extension and inner inverse matrix from static condensation\n"
+                     "  in single precision. Halves their memory, products are still computed in\n"
+                     "  double precision\n",
+                     py::arg("reuse_elmats") = "bool = False\n"
+                     "  keep the element matrices and reuse them in the next assembly for\n"
+                     "  elements which were not changed by mesh refinement. Requires that\n"
+                     "  the integrands do not change between assemblies. Only the computation\n"
+                     "  of element matrices is saved, the matrix graph and preconditioners are\n"
+                     "  rebuilt. Not used while the mesh has a deformation\n",
                      py::arg("eliminate_hidden") = "bool = False\n"
                      "  Set up BilinearForm for static condensation of hidden\n"
                      "  dofs. May be overruled by eliminate_internal.",
@@ -3028,6 +3049,10 @@ integrator : ngsolve.fem.LFI
     .def ("Prolongate", &Prolongation::ProlongateInline, py::arg("finelevel"), py::arg("vec"))
     .def ("Restrict", &Prolongation::RestrictInline, py::arg("finelevel"), py::arg("vec"))
     .def ("CreateMatrix", &Prolongation::CreateProlongationMatrix, py::arg("finelevel"))
+    .def ("Matrix", &Prolongation::GetProlongationMatrix, py::arg("finelevel"),
+          "cached prolongation matrix")
+    .def ("RestrictionMatrix", &Prolongation::GetRestrictionMatrix, py::arg("finelevel"),
+          "cached transposed prolongation matrix")
     .def ("LevelDofs", &Prolongation::LevelDofs, py::arg("level"))
     .def ("Operator", [](shared_ptr<Prolongation> prol, int level) -> shared_ptr<BaseMatrix>
           {
@@ -3059,17 +3084,31 @@ integrator : ngsolve.fem.LFI
                    // cout << "func-ptr = " << func.target<callbackfunc>() << endl;
                    // cout << "function pointer " << (void*)(*func.target<callbackfunc>()) << endl;
 
-                   flags.SetFlag("blockcreator", func);
+                   // called from Update/Assemble, which run with released GIL
+                   function<shared_ptr<Table<DofId>>(const FESpace&)> lam =
+                     [func](const FESpace & fes) -> shared_ptr<Table<DofId>>
+                     {
+                       py::gil_scoped_acquire aq;
+                       return func(fes);
+                     };
+                   flags.SetFlag("blockcreator", lam);
                  }
                else
                  {
                    cout << "could not extract C++ function" << endl;                   
                    // cout << "create a wrapper" << endl;
+                   // the flags (and copies of the lambda) live without the GIL,
+                   // the python object is only touched with the GIL held
+                   auto pbc = shared_ptr<py::object> (new py::object(bc), [] (py::object * p)
+                                                      {
+                                                        py::gil_scoped_acquire aq;
+                                                        delete p;
+                                                      });
                    function<shared_ptr<Table<DofId>>(const FESpace&)> lam =
-                     [bc](const FESpace & fes) -> shared_ptr<Table<DofId>>
+                     [pbc](const FESpace & fes) -> shared_ptr<Table<DofId>>
                      {
                        py::gil_scoped_acquire aq;
-                       py::object blocks = bc(py::cast(fes));
+                       py::object blocks = (*pbc)(py::cast(fes));
 
                        if (py::isinstance<Table<DofId>>(blocks))
                          return py::cast<shared_ptr<Table<DofId>>>(blocks);
@@ -3105,6 +3144,7 @@ integrator : ngsolve.fem.LFI
            auto creator = GetPreconditionerClasses().GetPreconditioner(type);
            if (creator == nullptr)
              throw Exception(string("nothing known about preconditioner '") + type + "'");
+           py::gil_scoped_release release;
            return creator->creatorbf(bfa, flags, type);
          }),
          py::arg("bf"), py::arg("type"))
@@ -3148,12 +3188,22 @@ integrator : ngsolve.fem.LFI
                     "  Smoother between multigrid levels, available options are:\n"
                     "    'point': Gauss-Seidel-Smoother\n"
                     "    'line':  Anisotropic smoother\n"
-                    "    'block': Block smoother";
+                    "    'block': Block smoother\n"
+                    "    'chebyshev': Chebyshev polynomial smoother";
+                  mg_flags["chebyshevdegree"] = "int = 3\n"
+                    "  Polynomial degree of the Chebyshev smoother";
+                  mg_flags["chebyshevratio"] = "double = 30\n"
+                    "  Chebyshev smoother damps the range [lmax/ratio, lmax]";
+                  mg_flags["chebyshevblocks"] = "bool = False\n"
+                    "  Chebyshev smoother uses block-Jacobi (blocktype) on the finest level";
                   mg_flags["coarsetype"] = "string = direct\n"
                     "  How to solve coarse problem.";
                   mg_flags["coarsesmoothingsteps"] = "int = 1\n"
                     "  If coarsetype is smoothing, then how many smoothingsteps will be done.";
                   mg_flags["updatealways"] = "bool = False\n";
+                  mg_flags["matrixprolongation"] = "bool = False\n"
+                    "  Use cached sparse prolongation/restriction matrices for\n"
+                    "  the grid transfer, if the prolongation provides them";
                   mg_flags["blocktype"] = "str = vertexpatch\n"
                     "  Blocktype used in compound FESpace for smoothing\n"
                     "  blocks. Options: vertexpatch, edgepatch";
@@ -3764,6 +3814,252 @@ element_wise: bool = False
         py::call_guard<py::gil_scoped_release>())
     ;
 
+  py::class_<CFIntegrator, shared_ptr<CFIntegrator>> (m, "CFIntegrator",
+                                                      R"raw(
+Reusable integration of one or many CoefficientFunctions.
+
+The setup (element list, compiled function, integration rules) is done once,
+calling the object integrates all functions in one pass over the elements.
+Useful for functionals evaluated in every time step. Sums are computed with
+compensated summation, the result does not depend on the number of threads.
+)raw")
+    .def(py::init([] (py::object cfs, variant<shared_ptr<MeshAccess>,Region> mesh_or_reg,
+                      VorB vb, int order, bool compile)
+                  {
+                    Array<shared_ptr<CoefficientFunction>> acfs;
+                    if (py::isinstance<py::list>(cfs) || py::isinstance<py::tuple>(cfs))
+                      for (auto cf : cfs)
+                        acfs.Append (py::cast<shared_ptr<CoefficientFunction>>(cf));
+                    else
+                      acfs.Append (py::cast<shared_ptr<CoefficientFunction>>(cfs));
+
+                    shared_ptr<MeshAccess> ma;
+                    optional<BitArray> mask;
+                    if (auto reg = get_if<Region>(&mesh_or_reg))
+                      {
+                        ma = reg->Mesh();
+                        vb = reg->VB();
+                        mask = BitArray(reg->Mask());
+                      }
+                    else
+                      ma = get<shared_ptr<MeshAccess>>(mesh_or_reg);
+
+                    py::gil_scoped_release release;
+                    return make_shared<CFIntegrator> (ma, vb, std::move(acfs), order,
+                                                      mask ? &*mask : nullptr, compile);
+                  }),
+         py::arg("cf"), py::arg("mesh"), py::arg("VOL_or_BND")=VOL, py::arg("order")=5,
+         py::arg("compile")=true,
+         R"raw(
+Parameters
+----------
+
+cf: ngsolve.CoefficientFunction or list of CoefficientFunctions
+  Functions to be integrated, may be vector valued.
+
+mesh: ngsolve.Mesh or ngsolve.Region
+  The mesh or the region to be integrated on.
+
+VOL_or_BND: ngsolve.VorB = VOL
+  Co-dimension to be integrated on, overwritten by a region.
+
+order: int = 5
+  Integration order.
+
+compile: bool = True
+  Compile the functions (without a C++ compiler) for faster evaluation.
+)raw")
+    .def_property_readonly("dim", &CFIntegrator::Dimension, "number of components of all functions together")
+    .def("__call__", [] (shared_ptr<CFIntegrator> self, bool element_wise) -> py::object
+         {
+           auto first = self->FirstComponent();
+           auto split = [&] (auto & sum) -> py::object
+             {
+               if (first.Size() == 2)
+                 {
+                   if (self->Dimension() == 1) return py::cast(sum(0));
+                   return py::cast(sum);
+                 }
+               py::list res;
+               for (size_t i = 0; i+1 < first.Size(); i++)
+                 {
+                   if (first[i+1]-first[i] == 1)
+                     res.append (py::cast(sum(first[i])));
+                   else
+                     {
+                       Vector<std::decay_t<decltype(sum(0))>> part = sum.Range(first[i], first[i+1]);
+                       res.append (py::cast(part));
+                     }
+                 }
+               return res;
+             };
+           auto integrate = [&] (auto tscal) -> py::object
+             {
+               typedef decltype(tscal) TSCAL;
+               Matrix<TSCAL> elvals(0, self->Dimension());
+               Vector<TSCAL> sum(self->Dimension());
+               {
+                 py::gil_scoped_release release;
+                 auto blh = lhp.GetLH();
+                 LocalHeap & lh = blh;
+                 if (element_wise)
+                   {
+                     elvals.SetSize (self->GetMeshAccess()->GetNE(self->GetVorB()), self->Dimension());
+                     elvals = TSCAL(0.0);
+                   }
+                 if constexpr (is_same_v<TSCAL,double>)
+                   sum = self->Integrate (lh, elvals);
+                 else
+                   sum = self->IntegrateComplex (lh, elvals);
+               }
+               if (element_wise)
+                 return py::make_tuple (split(sum), py::cast(elvals));
+               return split(sum);
+             };
+           if (self->IsComplex())
+             return integrate(Complex(0.0));
+           return integrate(double(0.0));
+         }, py::arg("element_wise")=false,
+         "Integrate all functions. Returns the integral of every function, with element_wise\n"
+         "additionally a matrix with the integrals over each element (rows) of all components.")
+    ;
+
+  py::class_<ExplicitTimeStepper, shared_ptr<ExplicitTimeStepper>> (m, "ExplicitTimeStepper",
+                                                                    R"raw(
+Explicit Runge-Kutta time stepping for  M du/dt = f - A(u)  with the mass matrix M
+of an L2 space, e.g. for DG discretizations of hyperbolic problems.
+
+The inverse mass matrix is applied element by element within the stage update,
+the work vectors are allocated once, and the whole run is done without the GIL.
+)raw")
+    .def(py::init([] (shared_ptr<FESpace> fes, py::object op, string scheme,
+                      shared_ptr<CoefficientFunction> rho, shared_ptr<BaseVector> rhs,
+                      shared_ptr<ParameterCoefficientFunction<double>> time)
+                  {
+                    shared_ptr<BaseMatrix> mat;
+                    if (py::isinstance<BilinearForm>(op))
+                      mat = make_shared<BilinearFormApplication> (py::cast<shared_ptr<BilinearForm>>(op), glh);
+                    else
+                      mat = py::cast<shared_ptr<BaseMatrix>>(op);
+                    py::gil_scoped_release release;
+                    return make_shared<ExplicitTimeStepper> (fes, mat, glh, scheme, rho, rhs, time);
+                  }),
+         py::arg("space"), py::arg("operator"), py::arg("scheme")="lsrk45",
+         py::arg("rho")=nullptr, py::arg("rhs")=nullptr, py::arg("time")=nullptr,
+         R"raw(
+Parameters
+----------
+
+space: ngsolve.FESpace
+  L2 space (or a product of L2 spaces) of the solution.
+
+operator: ngsolve.BilinearForm or ngsolve.BaseMatrix
+  The operator A, a BilinearForm is applied matrix-free (and may be nonlinear).
+
+scheme: str = "lsrk45"
+  euler, ssprk2, ssprk3 (strong stability preserving), or lsrk45 (4th order, low storage).
+
+rho: ngsolve.CoefficientFunction = None
+  Density in the mass matrix.
+
+rhs: ngsolve.BaseVector = None
+  Constant right hand side f.
+
+time: ngsolve.Parameter = None
+  Set to the stage times during a step, for time-dependent coefficients.
+)raw")
+    .def_property_readonly("scheme", &ExplicitTimeStepper::Scheme)
+    .def_property_readonly("stages", &ExplicitTimeStepper::NumStages)
+    .def_property_readonly("diagonal_mass", &ExplicitTimeStepper::DiagonalMass,
+                           "inverse mass matrix is diagonal and precomputed")
+    .def("Step", [] (shared_ptr<ExplicitTimeStepper> self,
+                     variant<shared_ptr<GridFunction>, shared_ptr<BaseVector>> u, double t, double dt)
+         {
+           shared_ptr<BaseVector> vec;
+           if (auto gf = get_if<shared_ptr<GridFunction>>(&u))
+             vec = (*gf)->GetVectorPtr();
+           else
+             vec = get<shared_ptr<BaseVector>>(u);
+           py::gil_scoped_release release;
+           auto blh = lhp.GetLH();
+           LocalHeap & lh = blh;
+           self->Step (*vec, t, dt, lh);
+         }, py::arg("u"), py::arg("t"), py::arg("dt"),
+         "One time step from t to t+dt, u is updated in place.")
+    .def("Run", [] (shared_ptr<ExplicitTimeStepper> self,
+                    variant<shared_ptr<GridFunction>, shared_ptr<BaseVector>> u, double t, double dt, int steps)
+         {
+           shared_ptr<BaseVector> vec;
+           if (auto gf = get_if<shared_ptr<GridFunction>>(&u))
+             vec = (*gf)->GetVectorPtr();
+           else
+             vec = get<shared_ptr<BaseVector>>(u);
+           py::gil_scoped_release release;
+           auto blh = lhp.GetLH();
+           LocalHeap & lh = blh;
+           return self->Run (*vec, t, dt, steps, lh);
+         }, py::arg("u"), py::arg("t"), py::arg("dt"), py::arg("steps"),
+         "Runs the given number of time steps starting at time t, returns the final time.")
+    ;
+
+  py::class_<SetValuesInterpolator, shared_ptr<SetValuesInterpolator>> (m, "SetValuesInterpolator",
+                                                                        R"raw(
+Reusable GridFunction.Set for one space.
+
+The local projections (inverse element mass or dual matrices applied to the
+weighted shape functions in the integration points) and the dof averaging
+weights are computed once. Set only evaluates the function and applies the
+element matrices, useful for time-dependent Dirichlet data or sources.
+)raw")
+    .def(py::init([] (shared_ptr<FESpace> fes, VorB vb, py::object definedon, bool dual,
+                      optional<shared_ptr<BitArray>> definedonelements, int bonus_intorder)
+                  {
+                    Region * reg = nullptr;
+                    if (py::extract<Region&> (definedon).check())
+                      reg = &py::extract<Region&>(definedon)();
+                    py::gil_scoped_release release;
+                    return make_shared<SetValuesInterpolator> (fes, vb, reg, glh, dual,
+                                                               definedonelements, bonus_intorder);
+                  }),
+         py::arg("space"),
+         py::arg("VOL_or_BND")=VOL,
+         py::arg("definedon")=DummyArgument(),
+         py::arg("dual")=false,
+         py::arg("definedonelements")=nullopt,
+         py::arg("bonus_intorder")=0,
+         R"raw(
+Parameters
+----------
+
+space: ngsolve.FESpace
+  Space of the GridFunctions to be set.
+
+VOL_or_BND: ngsolve.VorB = VOL
+  As in GridFunction.Set, with BND only the Dirichlet boundaries are set.
+
+definedon: ngsolve.Region
+  Set only on this region.
+
+dual: bool = False
+  Use dual shapes instead of the local L2-projection.
+
+definedonelements: ngsolve.BitArray
+  Set only on these elements.
+
+bonus_intorder: int = 0
+  Increase numerical integration order.
+)raw")
+    .def_property_readonly("memory", &SetValuesInterpolator::MemoryUsage,
+                           "memory of the precomputed matrices in bytes")
+    .def("Set", [] (shared_ptr<SetValuesInterpolator> self, spCF cf, shared_ptr<GridFunction> gf, int mdcomp)
+         {
+           self->Set (cf, *gf, glh, mdcomp);
+         },
+         py::arg("coefficient"), py::arg("gf"), py::arg("mdcomp")=0,
+         py::call_guard<py::gil_scoped_release>(),
+         "Set the GridFunction gf to the interpolant of the coefficient, same result as gf.Set")
+    ;
+
 
   m.def ("Integrate",
          [] (const SumOfIntegrals & igls, const MeshAccess & ma, bool element_wise) -> py::object
@@ -4549,7 +4845,7 @@ Interpolation is done on the fly for each element, no global GridFunction is all
 	     { op = ConvertOperator(spacea, spaceb, vb, glh, nullptr, trial_cf, reg, range_dofs, localop, parmat, use_simd, bonus_io_ab, bonus_io_bb, geom_free); }
 
 	   return op;
-	 },
+	 }, py::call_guard<py::gil_scoped_release>(),
 	 py::arg("spacea"), py::arg("spaceb"),
 	 py::arg("trial_proxy") = nullptr,
 	 py::arg("trial_cf") = nullptr,
@@ -4602,7 +4898,10 @@ bonus_intorder_ab/bb: int
 spacea/spaceb integrals.
 
 geom_free:
-  If True, assembles a matrix-free operator.
+  If True, assembles a matrix-free operator. The local operator is computed once per element class
+  (element type, vertex ordering and local number of dofs of both spaces) and used for all elements of
+  the class. This is only correct if the conversion does not depend on the geometry, e.g. between spaces
+  mapped alike. If False, the local operators are computed on every element, also for affine elements.
 )raw_string")
 	 );
 
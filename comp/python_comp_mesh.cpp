@@ -588,6 +588,27 @@ mesh (netgen.Mesh): a mesh generated from Netgen
                   &MeshAccess::GetDeformation,
                   &MeshAccess::SetDeformation, "mesh deformation")
 
+    .def("EnableGeometryCache", &MeshAccess::EnableGeometryCache,
+         py::arg("memory")=512*1024*1024,
+         docu_string(R"raw_string(
+Store mapped integration points and Jacobians of curved elements,
+such that repeated assembling or operator application does not
+re-evaluate the curved geometry. The cache is cleared when the
+mesh is refined, curved or deformed.
+
+Parameters:
+
+memory : int
+  memory budget of the cache in bytes
+
+)raw_string"))
+    .def("DisableGeometryCache", &MeshAccess::DisableGeometryCache,
+         "disable and release the geometry cache")
+    .def("ClearGeometryCache", &MeshAccess::ClearGeometryCache,
+         "clear the geometry cache, required after modifying netgen mesh points in place")
+    .def_property_readonly("geometry_cache_memory", &MeshAccess::GetGeometryCacheMemory,
+                           "memory used by the geometry cache in bytes")
+
     .def("SetPML", 
 	 [](MeshAccess & ma,  shared_ptr<PML> apml, py::object definedon)
           {
@@ -835,7 +856,7 @@ will create a CF being 1e6 on the top boundary and 0. elsewhere.
             ma.HPRefinement(levels, factor);
             // Ng_HPRefinement(levels, factor);
             // ma.UpdateBuffers();
-          },
+          }, py::call_guard<py::gil_scoped_release>(),
          py::arg("levels"), py::arg("factor")=0.125,
 	 "Geometric mesh refinement towards marked vertices and edges, uses factor for placement of new points")
 
@@ -888,7 +909,7 @@ will create a CF being 1e6 on the top boundary and 0. elsewhere.
          {
            self->Curve(order);
            return self;
-         },
+         }, py::call_guard<py::gil_scoped_release>(),
          py::arg("order"),
          "Curve the mesh elements for geometry approximation of given order")
 
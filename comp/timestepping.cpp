@@ -0,0 +1,220 @@
+/**********************************************************************/
+/* File:   timestepping.cpp                                           */
+/**********************************************************************/
+
+/*
+   Explicit Runge-Kutta time stepping for DG discretizations
+*/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  // spaces with a working SolveM: the L2 spaces, and products of them
+  static bool HasSolveM (const FESpace & fes)
+  {
+    if (dynamic_cast<const L2HighOrderFESpace*> (&fes) ||
+        dynamic_cast<const L2SurfaceHighOrderFESpace*> (&fes) ||
+        dynamic_cast<const VectorL2FESpace*> (&fes) ||
+        dynamic_cast<const TangentialSurfaceL2FESpace*> (&fes))
+      return true;
+    if (auto compound = dynamic_cast<const CompoundFESpace*> (&fes))
+      {
+        for (int i = 0; i < compound->GetNSpaces(); i++)
+          if (!HasSolveM (*(*compound)[i]))
+            return false;
+        return compound->GetNSpaces() > 0;
+      }
+    return false;
+  }
+
+  ExplicitTimeStepper ::
+  ExplicitTimeStepper (shared_ptr<FESpace> afes, shared_ptr<BaseMatrix> aop,
+                       LocalHeap & lh, string ascheme,
+                       shared_ptr<CoefficientFunction> arho,
+                       shared_ptr<BaseVector> arhs,
+                       shared_ptr<ParameterCoefficientFunction<double>> atime)
+    : fes(afes), op(aop), rho(arho), rhs(arhs), time(atime), scheme(ascheme)
+  {
+    static Timer t("ExplicitTimeStepper - setup"); RegionTimer rt(t);
+
+    if (fes->IsComplex() || op->IsComplex())
+      throw Exception ("ExplicitTimeStepper: complex spaces not supported");
+    if (!HasSolveM (*fes))
+      throw Exception ("ExplicitTimeStepper needs an L2 space or a product of L2 spaces, got "
+                       + fes->GetClassName());
+    if (rho && rho->Dimension() != 1)
+      throw Exception ("ExplicitTimeStepper needs a scalar density");
+
+    if (scheme == "euler")
+      {
+        coef_a = { 0 };
+        coef_b = { 1 };
+        coef_c = { 0 };
+      }
+    else if (scheme == "ssprk2")
+      {
+        coef_a = { 0, 0.5 };
+        coef_b = { 1, 0.5 };
+        coef_c = { 0, 1 };
+      }
+    else if (scheme == "ssprk3")
+      {
+        coef_a = { 0, 3.0/4, 1.0/3 };
+        coef_b = { 1, 1.0/4, 2.0/3 };
+        coef_c = { 0, 1, 0.5 };
+      }
+    else if (scheme == "lsrk45")
+      {
+        low_storage = true;
+        coef_a = { 0.0,
+                   -567301805773.0/1357537059087.0,
+                   -2404267990393.0/2016746695238.0,
+                   -3550918686646.0/2091501179385.0,
+                   -1275806237668.0/842570457699.0 };
+        coef_b = { 1432997174477.0/9575080441755.0,
+                   5161836677717.0/13612068292357.0,
+                   1720146321549.0/2090206949498.0,
+                   3134564353537.0/4481467310338.0,
+                   2277821191437.0/14882151754819.0 };
+        coef_c = { 0.0,
+                   1432997174477.0/9575080441755.0,
+                   2526269341429.0/6820363962896.0,
+                   2006345519317.0/3224310063776.0,
+                   2802321613138.0/2924317926251.0 };
+      }
+    else
+      throw Exception ("ExplicitTimeStepper: unknown scheme '" + scheme +
+                       "', available are euler, ssprk2, ssprk3, lsrk45");
+
+    res = op->CreateColVector();
+    reg = op->CreateColVector();
+
+    // diagonal inverse mass for straight elements, as in L2HighOrderFESpace::SolveM
+    if (dynamic_pointer_cast<L2HighOrderFESpace>(fes) && (!rho || rho->ElementwiseConstant()))
+      {
+        int dim = fes->GetDimension();
+        inv_mass.SetSize (fes->GetNDof()*dim);
+        inv_mass = 0.0;
+        atomic<bool> diagonal(true);
+        IterateElements (*fes, VOL, lh,
+                         [&] (FESpace::Element el, LocalHeap & lh)
+                         {
+                           auto & fel = static_cast<const BaseScalarFiniteElement&>(el.GetFE());
+                           const ElementTransformation & trafo = el.GetTrafo();
+                           if (trafo.IsCurvedElement())
+                             {
+                               diagonal = false;
+                               return;
+                             }
+
+                           FlatVector<double> diag_mass(fel.GetNDof(), lh);
+                           fel.GetDiagMassMatrix (diag_mass);
+
+                           IntegrationRule ir(fel.ElementType(), 0);
+                           BaseMappedIntegrationRule & mir = trafo(ir, lh);
+                           double jac = mir[0].GetMeasure();
+                           if (rho) jac *= rho->Evaluate(mir[0]);
+
+                           auto dnums = el.GetDofs();
+                           for (auto i : Range(dnums))
+                             if (IsRegularDof(dnums[i]))
+                               for (auto j : Range(dim))
+                                 inv_mass(dim*dnums[i]+j) = 1.0 / (jac * diag_mass(i));
+                         });
+        if (!diagonal)
+          inv_mass.SetSize(0);
+      }
+  }
+
+
+  void ExplicitTimeStepper :: Step (BaseVector & u, double t, double dt, LocalHeap & lh)
+  {
+    static Timer t_step("ExplicitTimeStepper - step"); RegionTimer rt(t_step);
+    static Timer t_op("ExplicitTimeStepper - operator");
+    static Timer t_minv("ExplicitTimeStepper - inverse mass");
+    static Timer t_update("ExplicitTimeStepper - update");
+
+    auto fu = u.FVDouble();
+    auto fres = res->FVDouble();
+    auto freg = reg->FVDouble();
+    if (fu.Size() != fres.Size())
+      throw Exception ("ExplicitTimeStepper: vector size " + ToString(fu.Size()) +
+                       " does not match operator size " + ToString(fres.Size()));
+    FlatVector<double> frhs = rhs ? rhs->FVDouble() : FlatVector<double>(0, (double*)nullptr);
+    if (rhs && frhs.Size() != fu.Size())
+      throw Exception ("ExplicitTimeStepper: right hand side has wrong size");
+
+    u.Cumulate();
+    if (!low_storage)
+      ParallelForRange (fu.Size(), [&] (IntRange r)
+                        { freg.Range(r) = fu.Range(r); });
+
+    bool diagonal = DiagonalMass();
+    for (auto s : Range(NumStages()))
+      {
+        if (time) time->SetValue (t + coef_c[s]*dt);
+
+        t_op.Start();
+        op->Mult (u, *res);
+        res->Cumulate();
+        t_op.Stop();
+
+        if (!diagonal)
+          {
+            // k = M^{-1} (f - A(u)), in place
+            RegionTimer rtm(t_minv);
+            ParallelForRange (fres.Size(), [&] (IntRange r)
+                              {
+                                if (rhs)
+                                  fres.Range(r) = frhs.Range(r) - fres.Range(r);
+                                else
+                                  fres.Range(r) *= -1;
+                              });
+            fes->SolveM (rho.get(), *res, nullptr, lh);
+          }
+
+        RegionTimer rtu(t_update);
+        double a = coef_a[s], b = coef_b[s];
+        ParallelForRange (fu.Size(), [&] (IntRange r)
+          {
+            for (auto i : r)
+              {
+                double k;
+                if (diagonal)
+                  k = inv_mass(i) * ((rhs ? frhs(i) : 0.0) - fres(i));
+                else
+                  k = fres(i);
+
+                if (low_storage)
+                  {
+                    // a = 0 in the first stage, du is not initialized
+                    double du = (a == 0 ? 0.0 : a*freg(i)) + dt*k;
+                    freg(i) = du;
+                    fu(i) += b*du;
+                  }
+                else
+                  fu(i) = (a == 0 ? 0.0 : a*freg(i)) + b*(fu(i) + dt*k);
+              }
+          });
+        t_update.AddFlops (6*fu.Size());
+      }
+
+    if (time) time->SetValue (t + dt);
+  }
+
+
+  double ExplicitTimeStepper :: Run (BaseVector & u, double t, double dt, int nsteps, LocalHeap & lh)
+  {
+    static Timer t_run("ExplicitTimeStepper - run"); RegionTimer rt(t_run);
+    for (int i = 0; i < nsteps; i++)
+      {
+        HeapReset hr(lh);
+        Step (u, t, dt, lh);
+        t += dt;
+      }
+    return t;
+  }
+
+}
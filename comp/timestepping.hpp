@@ -0,0 +1,81 @@
+#ifndef FILE_TIMESTEPPING
+#define FILE_TIMESTEPPING
+
+/**********************************************************************/
+/* File:   timestepping.hpp                                           */
+/**********************************************************************/
+
+/*
+   Explicit Runge-Kutta time stepping for DG discretizations
+*/
+
+
+namespace ngcomp
+{
+
+  /**
+     Explicit Runge-Kutta methods for the semi-discrete system
+
+       M du/dt = f - A(u)
+
+     with the block-diagonal mass matrix M of an L2 space, a (non-)linear
+     operator A, e.g. a matrix-free BilinearForm, and an optional constant
+     right hand side f.
+
+     For straight elements and an element-wise constant density the inverse
+     mass matrix is diagonal. It is precomputed once and applied within the
+     stage update, so a stage is one operator application plus one pass over
+     the vectors. Otherwise the stage vector is multiplied by the inverse
+     mass in place (FESpace::SolveM). The work vectors are allocated once.
+
+     Schemes:
+       euler   forward Euler
+       ssprk2  2 stage, 2nd order SSP (Heun)
+       ssprk3  3 stage, 3rd order SSP (Shu-Osher)
+       lsrk45  5 stage, 4th order low-storage (Carpenter-Kennedy, 2N storage)
+  */
+  class NGS_DLL_HEADER ExplicitTimeStepper
+  {
+    shared_ptr<FESpace> fes;
+    shared_ptr<BaseMatrix> op;
+    shared_ptr<CoefficientFunction> rho;
+    shared_ptr<BaseVector> rhs;
+    shared_ptr<ParameterCoefficientFunction<double>> time;
+    string scheme;
+
+    /*
+      stage coefficients
+        SSP (Shu-Osher form):  u = a u0 + b (u + dt k)
+        low-storage:           du = a du + dt k,  u += b du
+      with k = M^{-1} (f - A(u)) evaluated at time t + c dt
+    */
+    Array<double> coef_a, coef_b, coef_c;
+    bool low_storage = false;
+
+    // diagonal of the inverse mass matrix, empty if not diagonal
+    Vector<double> inv_mass;
+
+    // operator output, and second register (u0 or du)
+    shared_ptr<BaseVector> res, reg;
+
+  public:
+    ExplicitTimeStepper (shared_ptr<FESpace> afes, shared_ptr<BaseMatrix> aop,
+                         LocalHeap & lh, string ascheme = "lsrk45",
+                         shared_ptr<CoefficientFunction> arho = nullptr,
+                         shared_ptr<BaseVector> arhs = nullptr,
+                         shared_ptr<ParameterCoefficientFunction<double>> atime = nullptr);
+
+    const string & Scheme() const { return scheme; }
+    int NumStages() const { return coef_c.Size(); }
+    bool DiagonalMass() const { return inv_mass.Size() > 0; }
+
+    /// one step from t to t+dt
+    void Step (BaseVector & u, double t, double dt, LocalHeap & lh);
+
+    /// nsteps steps starting at time t, returns the final time
+    double Run (BaseVector & u, double t, double dt, int nsteps, LocalHeap & lh);
+  };
+
+}
+
+#endif
@@ -798,6 +798,23 @@ namespace ngfem
       throw Exception ("FacetBilinearFormIntegrator::ApplyFacetMatrix for inner facets not implemented!");
     }
 
+    /*
+      apply to a batch of inner facets, one row of elx/ely per facet.
+      The neighbour elements of all facets agree in finite element, local
+      facet number and relative vertex ordering (ElVertices of the first facet).
+      Returns false if not supported, the caller applies facet by facet then.
+    */
+    virtual bool
+      ApplyFacetMatrixBatch (const FiniteElement & volumefel1, int LocalFacetNr1,
+                             FlatArray<const ElementTransformation*> eltrans1, FlatArray<int> & ElVertices1,
+                             const FiniteElement & volumefel2, int LocalFacetNr2,
+                             FlatArray<const ElementTransformation*> eltrans2, FlatArray<int> & ElVertices2,
+                             FlatMatrix<double> elx, FlatMatrix<double> ely,
+                             LocalHeap & lh) const
+    {
+      return false;
+    }
+
 
     virtual void
     CalcFacetMatrix (const FiniteElement & volumefel, int LocalFacetNr,
@@ -66,6 +66,8 @@ namespace ngfem
 
     typedef HashTable<INT<2>, Matrix<>*> TPRECOMP_GRAD;
     static TPRECOMP_GRAD precomp_grad;
+
+    static PrecomputedSIMDShapesContainer<DIM> precomp_simd;
 #endif
 
   public:
@@ -124,6 +126,20 @@ namespace ngfem
     using BASE::EvaluateGradTrans;
     HD NGS_DLL_HEADER virtual void EvaluateGradTrans (const IntegrationRule & ir, FlatMatrixFixWidth<DIM> values, BareSliceVector<> coefs) const override;
 
+    /// shapes tabulated on ir (for high order), or nullptr 
+    const PrecomputedSIMDShapes<DIM> * GetPrecomputedSIMDShapes (const SIMD_IntegrationRule & ir) const;
+    
+    HD NGS_DLL_HEADER virtual void Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const override;
+    using BASE::AddTrans;
+    HD NGS_DLL_HEADER virtual void AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const override;
+    HD NGS_DLL_HEADER virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & ir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const override;
+    using BASE::AddGradTrans;
+    HD NGS_DLL_HEADER virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const override;
+    using BASE::CalcShape;
+    HD NGS_DLL_HEADER virtual void CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shapes) const override;
+    using BASE::CalcMappedDShape;
+    HD NGS_DLL_HEADER virtual void CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> dshapes) const override;
+
     NGS_DLL_HEADER virtual void GetGradient (FlatVector<> coefs, FlatMatrixFixWidth<DIM> grad) const override;
     NGS_DLL_HEADER virtual void GetGradientTrans (FlatMatrixFixWidth<DIM> grad, FlatVector<> coefs) const override;
 
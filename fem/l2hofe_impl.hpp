@@ -22,6 +22,9 @@ namespace ngfem
 
   template <ELEMENT_TYPE ET, class SHAPES, class BASE>
   typename L2HighOrderFE<ET,SHAPES,BASE>::TPRECOMP_GRAD L2HighOrderFE<ET,SHAPES,BASE>::precomp_grad(40);
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  PrecomputedSIMDShapesContainer<L2HighOrderFE<ET,SHAPES,BASE>::DIM> L2HighOrderFE<ET,SHAPES,BASE>::precomp_simd;
 #endif
 
 
@@ -164,6 +167,199 @@ namespace ngfem
     }
 
 
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  auto L2HighOrderFE<ET,SHAPES,BASE> :: 
+  GetPrecomputedSIMDShapes (const SIMD_IntegrationRule & ir) const -> const PrecomputedSIMDShapes<DIM> * 
+  {
+#ifndef __CUDA_ARCH__
+    // the class number determines the vertex ordering only for these elements
+    if constexpr (ET == ET_SEGM || ET == ET_TRIG || ET == ET_QUAD || ET == ET_TET)
+      {
+        if (order < PRECOMPUTED_SIMD_SHAPES_MINORDER) return nullptr;
+        
+        int classnr = ET_trait<ET>::GetClassNr (vnums);
+        if (auto pre = precomp_simd.Get (classnr, order, order_inner, ir))
+          return pre;
+        if (precomp_simd.Full()) return nullptr;
+
+        static Timer t("L2HighOrderFE - tabulate SIMD shapes");
+        RegionTimer reg(t);
+        
+        auto pre = new PrecomputedSIMDShapes<DIM> (classnr, order, order_inner, ir, ndof);
+        size_t nip = ir.Size();
+        for (size_t k = 0; k < nip; k++)
+          this->T_CalcShape (GetTIPGrad<DIM> (ir[k]),
+                             SBLambda ([pre,k,nip] (size_t i, auto shape)
+                                       {
+                                         pre->shapes(i,k) = shape.Value();
+                                         for (int d = 0; d < DIM; d++)
+                                           pre->dshapes(i,d*nip+k) = shape.DValue(d);
+                                       }));
+        return precomp_simd.Add (pre);
+      }
+#endif
+    return nullptr;
+  }
+
+  
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    auto pre = GetPrecomputedSIMDShapes (ir);
+    if (!pre)
+      {
+        BASE::Evaluate (ir, coefs, values);
+        return;
+      }
+
+    size_t nip = ir.Size();
+    for (size_t k = 0; k < nip; k++)
+      values(k) = SIMD<double>(0.0);
+    for (size_t i = 0; i < ndof; i++)
+      {
+        SIMD<double> ci = coefs(i);
+        auto row = pre->shapes.Row(i);
+        for (size_t k = 0; k < nip; k++)
+          values(k) += ci * row(k);
+      }
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    auto pre = GetPrecomputedSIMDShapes (ir);
+    if (!pre)
+      {
+        BASE::AddTrans (ir, values, coefs);
+        return;
+      }
+
+    size_t nip = ir.Size();
+    for (size_t i = 0; i < ndof; i++)
+      {
+        SIMD<double> sum = 0.0;
+        auto row = pre->shapes.Row(i);
+        for (size_t k = 0; k < nip; k++)
+          sum += row(k) * values(k);
+        coefs(i) += HSum(sum);
+      }
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr (DIM > 0)
+      if (bmir.DimSpace() == DIM)
+        if (auto pre = GetPrecomputedSIMDShapes (bmir.IR()))
+          {
+            auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+            size_t nip = mir.Size();
+            
+            // reference gradients, gref[d*nip+k]
+            STACK_ARRAY(SIMD<double>, gref, DIM*nip);
+            for (size_t j = 0; j < DIM*nip; j++)
+              gref[j] = SIMD<double>(0.0);
+            for (size_t i = 0; i < ndof; i++)
+              {
+                SIMD<double> ci = coefs(i);
+                auto row = pre->dshapes.Row(i);
+                for (size_t j = 0; j < DIM*nip; j++)
+                  gref[j] += ci * row(j);
+              }
+            
+            for (size_t k = 0; k < nip; k++)
+              {
+                Vec<DIM,SIMD<double>> gk;
+                for (int d = 0; d < DIM; d++)
+                  gk(d) = gref[d*nip+k];
+                values.Col(k).Range(DIM) = Trans(mir[k].GetJacobianInverse()) * gk;
+              }
+            return;
+          }
+    BASE::EvaluateGrad (bmir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    if constexpr (DIM > 0)
+      if (bmir.DimSpace() == DIM)
+        if (auto pre = GetPrecomputedSIMDShapes (bmir.IR()))
+          {
+            auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+            size_t nip = mir.Size();
+            
+            STACK_ARRAY(SIMD<double>, gref, DIM*nip);
+            for (size_t k = 0; k < nip; k++)
+              {
+                Vec<DIM,SIMD<double>> vk;
+                for (int d = 0; d < DIM; d++)
+                  vk(d) = values(d,k);
+                Vec<DIM,SIMD<double>> jac_dir = mir[k].GetJacobianInverse() * vk;
+                for (int d = 0; d < DIM; d++)
+                  gref[d*nip+k] = jac_dir(d);
+              }
+            
+            for (size_t i = 0; i < ndof; i++)
+              {
+                SIMD<double> sum = 0.0;
+                auto row = pre->dshapes.Row(i);
+                for (size_t j = 0; j < DIM*nip; j++)
+                  sum += row(j) * gref[j];
+                coefs(i) += HSum(sum);
+              }
+            return;
+          }
+    BASE::AddGradTrans (bmir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shapes) const
+  {
+    auto pre = GetPrecomputedSIMDShapes (ir);
+    if (!pre)
+      {
+        BASE::CalcShape (ir, shapes);
+        return;
+      }
+    shapes.AddSize(ndof, ir.Size()) = pre->shapes;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> :: 
+  CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> dshapes) const
+  {
+    if constexpr (DIM > 0)
+      if (bmir.DimSpace() == DIM)
+        if (auto pre = GetPrecomputedSIMDShapes (bmir.IR()))
+          {
+            // row i*DIM+d of dshapes is the d-th derivative of shape i
+            auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+            size_t nip = mir.Size();
+            for (size_t k = 0; k < nip; k++)
+              {
+                auto jacinv = mir[k].GetJacobianInverse();
+                for (size_t i = 0; i < ndof; i++)
+                  {
+                    Vec<DIM,SIMD<double>> gref;
+                    for (int d = 0; d < DIM; d++)
+                      gref(d) = pre->dshapes(i, d*nip+k);
+                    Vec<DIM,SIMD<double>> grad = Trans(jacinv) * gref;
+                    for (int d = 0; d < DIM; d++)
+                      dshapes(i*DIM+d, k) = grad(d);
+                  }
+              }
+            return;
+          }
+    BASE::CalcMappedDShape (bmir, dshapes);
+  }
+
+  
   template <ELEMENT_TYPE ET, class SHAPES, class BASE>
   void L2HighOrderFE<ET,SHAPES,BASE> :: 
   GetGradient (FlatVector<> coefs, FlatMatrixFixWidth<DIM> grad) const
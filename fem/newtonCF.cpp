@@ -69,6 +69,76 @@ bool all_converged_qp(const mat_t &res, double tol, vec_t res_0 = 0, double rtol
                      });
 }
 
+// L-infinity norms of the SIMD lanes of a vector, NaN if a lane contains NaN
+template <typename vec_t>
+SIMD<double> lane_norms(const vec_t &vec) {
+  return SIMD<double>([&](int lane) -> double {
+    double s = 0;
+    for (size_t k : Range(vec.Size())) {
+      double v = vec(k)[lane];
+      if (isnan(v))
+        return numeric_limits<double>::quiet_NaN();
+      s = max(s, fabs(v));
+    }
+    return s;
+  });
+}
+
+// 1 for lanes which have not converged yet, 0 for converged lanes and
+// lanes beyond the number of valid points
+template <typename vec_t>
+SIMD<double> active_lanes(const vec_t &vec, SIMD<double> res_0, double tol,
+                          double rtol, size_t first, size_t nvalid) {
+  SIMD<double> res = lane_norms(vec);
+  return SIMD<double>([&](int lane) -> double {
+    if (first + lane >= nvalid)
+      return 0;
+    double r = res[lane], r0 = res_0[lane];
+    bool conv = r <= tol || (r0 > 0 && (r / r0) <= rtol);
+    return conv ? 0 : 1;
+  });
+}
+
+// Solves the small dense systems of all SIMD lanes at once by Gaussian
+// elimination with partial pivoting in every lane. The solution overwrites b.
+void SolveSIMD(FlatMatrix<SIMD<double>> a, FlatVector<SIMD<double>> b) {
+  size_t n = a.Height();
+  for (size_t k = 0; k < n; k++) {
+    SIMD<double> maxval = fabs(a(k, k));
+    SIMD<double> piv(double(k));
+    for (size_t r = k + 1; r < n; r++) {
+      SIMD<double> diff = fabs(a(r, k)) - maxval;
+      maxval = IfPos(diff, fabs(a(r, k)), maxval);
+      piv = IfPos(diff, SIMD<double>(double(r)), piv);
+    }
+    for (size_t r = k + 1; r < n; r++) {
+      // swap rows k and r in the lanes with pivot row r
+      SIMD<double> swap = 0.5 - fabs(piv - SIMD<double>(double(r)));
+      for (size_t c = k; c < n; c++) {
+        SIMD<double> tmp = a(k, c);
+        a(k, c) = IfPos(swap, a(r, c), tmp);
+        a(r, c) = IfPos(swap, tmp, a(r, c));
+      }
+      SIMD<double> tmp = b(k);
+      b(k) = IfPos(swap, b(r), tmp);
+      b(r) = IfPos(swap, tmp, b(r));
+    }
+    SIMD<double> inv = 1.0 / a(k, k);
+    for (size_t r = k + 1; r < n; r++) {
+      SIMD<double> f = a(r, k) * inv;
+      for (size_t c = k + 1; c < n; c++)
+        a(r, c) -= f * a(k, c);
+      b(r) -= f * b(k);
+    }
+  }
+  for (size_t k = n; k-- > 0;) {
+    SIMD<double> sum = b(k);
+    for (size_t c = k + 1; c < n; c++)
+      sum -= a(k, c) * b(c);
+    b(k) = sum / a(k, k);
+  }
+}
+
 } // namespace
 
 class NewtonCF : public CoefficientFunction {
@@ -475,6 +545,144 @@ public:
     //    "\n--------------------- NewtonCF done ---------------------------\n";
   }
 
+  // SIMD version: the Newton iteration runs for all lanes simultaneously,
+  // converged lanes are masked out. Only for square systems without
+  // VS embedding, otherwise the scalar version is used.
+  void Evaluate(const SIMD_BaseMappedIntegrationRule &mir,
+                BareSliceMatrix<SIMD<double>> values) const override {
+    if (eq_dim != full_dim || numeric_dim != full_dim)
+      throw ExceptionNOSIMD("NewtonCF: SIMD evaluation only for square systems without VS embedding");
+
+    static Timer t("NewtonCF::Eval SIMD", NoTracing);
+    static Timer t1("NewtonCF::Eval SIMD get Jac", NoTracing);
+    static Timer t2("NewtonCF::Eval SIMD solve", NoTracing);
+    RegionTimer reg(t);
+
+    constexpr size_t SW = SIMD<double>::Size();
+    const size_t np = mir.Size();
+    const size_t nvalid = min(mir.IR().GetNIP(), np * SW);
+
+    LocalHeap lh(1000000);
+
+    const ElementTransformation &trafo = mir.GetTransformation();
+    auto saved_ud = trafo.PushUserData();
+
+    ProxyUserData ud(proxies.Size(), cachecf.Size(), lh);
+    for (CoefficientFunction *cf : cachecf)
+      ud.AssignMemory(cf, np * SW, cf->Dimension(), lh);
+
+    const_cast<ElementTransformation &>(trafo).userdata = &ud;
+
+    for (ProxyFunction *proxy : proxies)
+      ud.AssignMemory(proxy, np * SW, proxy->Dimension(), lh);
+
+    // needed for evaluation of compiled expressions
+    DummyFE<ET_TRIG> dummyfe;
+    ud.fel = &dummyfe;
+
+    const auto nblocks = proxies.Size();
+    FlatArray<FlatMatrix<SIMD<double>>> xk_blocks(nblocks, lh);
+    for (auto i : Range(nblocks))
+      xk_blocks[i].Assign(ud.GetAMemory(proxies[i]));
+
+    FlatMatrix<SIMD<double>> xk(full_dim, np, lh);
+    FlatMatrix<SIMD<double>> res(eq_dim, np, lh);
+    FlatMatrix<AutoDiff<1, SIMD<double>>> dval(eq_dim, np, lh);
+    FlatArray<FlatMatrix<SIMD<double>>> jac(np, lh);
+    for (auto i : Range(np))
+      jac[i].AssignMemory(eq_dim, full_dim, lh);
+    FlatVector<SIMD<double>> res_0(np, lh);
+    FlatVector<SIMD<double>> active(np, lh);
+
+    FlatMatrix<SIMD<double>> lhs(eq_dim, full_dim, lh);
+    FlatVector<SIMD<double>> rhs(eq_dim, lh);
+
+    const auto distribute_xk = [&]() {
+      size_t offset = 0;
+      for (auto xkb : xk_blocks) {
+        auto next = offset + xkb.Height();
+        xkb = xk.Rows(offset, next);
+        offset = next;
+      }
+    };
+
+    const auto update_active = [&]() -> bool {
+      bool any = false;
+      for (auto i : Range(np)) {
+        active(i) = active_lanes(res.Col(i), res_0(i), tol, rtol, i * SW, nvalid);
+        any |= HSum(active(i)) > 0;
+      }
+      return any;
+    };
+
+    // Evaluate starting point
+    if (startingpoints.Size() == proxies.Size()) {
+      size_t offset = 0;
+      for (int i : Range(startingpoints)) {
+        startingpoints[i]->Evaluate(mir, xk_blocks[i]);
+        auto next = offset + xk_blocks[i].Height();
+        xk.Rows(offset, next) = xk_blocks[i];
+        offset = next;
+      }
+    } else {
+      assert(startingpoints.Size() == 1);
+      startingpoints[0]->Evaluate(mir, xk);
+      distribute_xk();
+    }
+
+    expression->Evaluate(mir, res);
+    for (auto i : Range(np))
+      res_0(i) = lane_norms(res.Col(i));
+
+    bool any_active = update_active();
+    for ([[maybe_unused]] int step : Range(maxiter)) {
+      if (!any_active)
+        break;
+
+      {
+        // all lanes at once, one evaluation per trial component
+        RegionTimer regtr1(t1);
+        size_t col = 0;
+        for (auto proxy : proxies)
+          for (auto l : Range(proxy->Dimension())) {
+            ud.trialfunction = proxy;
+            ud.trial_comp = l;
+            expression->Evaluate(mir, dval);
+            for (auto i : Range(np))
+              for (auto k : Range(eq_dim))
+                jac[i](k, col) = dval(k, i).DValue(0);
+            col++;
+          }
+        ud.trialfunction = nullptr;
+      }
+
+      {
+        RegionTimer regtr2(t2);
+        for (auto i : Range(np)) {
+          if (HSum(active(i)) == 0)
+            continue;
+          lhs = jac[i];
+          rhs = res.Col(i);
+          SolveSIMD(lhs, rhs);
+          for (auto k : Range(full_dim))
+            xk(k, i) -= IfPos(active(i) - 0.5, rhs(k), SIMD<double>(0.0));
+        }
+      }
+
+      distribute_xk();
+      expression->Evaluate(mir, res);
+      any_active = update_active();
+    }
+
+    if (any_active) {
+      cout << IM(4) << "The NewtonCF did not converge to tolerance on element " << trafo.GetElementNr() << endl;
+      if (!allow_fail)
+        xk = SIMD<double>(numeric_limits<double>::quiet_NaN());
+    }
+
+    values.AddSize(full_dim, np) = xk;
+  }
+
 private:
     template <typename src_t, typename dest_t>
     void expand_increments(const src_t src, dest_t dest) const
@@ -1137,6 +1345,222 @@ public:
     // cout << "result = " << xk << endl;
     values.AddSize(mir.Size(), Dimension()) = xk;
   }
+
+  // SIMD version: Newton iteration with a line search in every lane,
+  // converged lanes are masked out. Only without VS embedding, otherwise
+  // the scalar version is used.
+  void Evaluate(const SIMD_BaseMappedIntegrationRule &mir,
+                BareSliceMatrix<SIMD<double>> values) const override {
+    if (numeric_dim != full_dim)
+      throw ExceptionNOSIMD("MinimizationCF: SIMD evaluation only without VS embedding");
+
+    static Timer t("MinimizationCF::Eval SIMD", NoTracing);
+    static Timer t1("MinimizationCF::Eval SIMD get Hessian", NoTracing);
+    static Timer t2("MinimizationCF::Eval SIMD solve", NoTracing);
+    RegionTimer reg(t);
+
+    constexpr size_t SW = SIMD<double>::Size();
+    const size_t np = mir.Size();
+    const size_t nvalid = min(mir.IR().GetNIP(), np * SW);
+
+    LocalHeap lh(1000000);
+
+    const ElementTransformation &trafo = mir.GetTransformation();
+    auto saved_ud = trafo.PushUserData();
+
+    ProxyUserData ud(proxies.Size(), cachecf.Size(), lh);
+    for (CoefficientFunction *cf : cachecf)
+      ud.AssignMemory(cf, np * SW, cf->Dimension(), lh);
+
+    const_cast<ElementTransformation &>(trafo).userdata = &ud;
+
+    for (ProxyFunction *proxy : proxies)
+      ud.AssignMemory(proxy, np * SW, proxy->Dimension(), lh);
+
+    // needed for evaluation of compiled expressions
+    DummyFE<ET_TRIG> dummyfe;
+    ud.fel = &dummyfe;
+
+    const auto nblocks = proxies.Size();
+    FlatArray<FlatMatrix<SIMD<double>>> xk_blocks(nblocks, lh);
+    for (auto i : Range(nblocks))
+      xk_blocks[i].Assign(ud.GetAMemory(proxies[i]));
+
+    // proxy and component of the unknowns
+    FlatArray<ProxyFunction *> comp_proxy(full_dim, lh);
+    FlatArray<int> comp_nr(full_dim, lh);
+    size_t ncomp = 0;
+    for (auto proxy : proxies)
+      for (auto k : Range(proxy->Dimension())) {
+        comp_proxy[ncomp] = proxy;
+        comp_nr[ncomp++] = k;
+      }
+
+    FlatMatrix<SIMD<double>> xk(full_dim, np, lh);
+    FlatMatrix<SIMD<double>> xold(full_dim, np, lh);
+    FlatMatrix<SIMD<double>> w(full_dim, np, lh);
+    FlatMatrix<SIMD<double>> grad(full_dim, np, lh);
+    FlatMatrix<AutoDiffDiff<1, SIMD<double>>> ddval(1, np, lh);
+    FlatArray<FlatMatrix<SIMD<double>>> hess(np, lh);
+    for (auto i : Range(np))
+      hess[i].AssignMemory(full_dim, full_dim, lh);
+    FlatVector<SIMD<double>> energy(np, lh);
+    FlatVector<SIMD<double>> newenergy(np, lh);
+    FlatVector<SIMD<double>> res_0(np, lh);
+    FlatVector<SIMD<double>> active(np, lh);
+    FlatVector<SIMD<double>> accepted(np, lh);
+
+    FlatMatrix<SIMD<double>> lhs(full_dim, full_dim, lh);
+    FlatVector<SIMD<double>> rhs(full_dim, lh);
+
+    const auto distribute_xk = [&]() {
+      size_t offset = 0;
+      for (auto xkb : xk_blocks) {
+        auto next = offset + xkb.Height();
+        xkb = xk.Rows(offset, next);
+        offset = next;
+      }
+    };
+
+    const auto set_direction = [&](size_t a, size_t b) {
+      ud.testfunction = comp_proxy[a];
+      ud.test_comp = comp_nr[a];
+      ud.trialfunction = comp_proxy[b];
+      ud.trial_comp = comp_nr[b];
+    };
+
+    const auto calc_energy = [&](FlatVector<SIMD<double>> e) {
+      set_direction(0, 0);
+      expression->Evaluate(mir, ddval);
+      for (auto i : Range(np))
+        e(i) = ddval(0, i).Value();
+    };
+
+    const auto calc_energy_grad_and_diags = [&]() {
+      for (auto a : Range(full_dim)) {
+        set_direction(a, a);
+        expression->Evaluate(mir, ddval);
+        for (auto i : Range(np)) {
+          grad(a, i) = ddval(0, i).DValue(0);
+          hess[i](a, a) = ddval(0, i).DDValue(0);
+        }
+        if (a == 0)
+          for (auto i : Range(np))
+            energy(i) = ddval(0, i).Value();
+      }
+    };
+
+    const auto calc_off_diagonals = [&]() {
+      // second derivative in direction e_a + e_b
+      for (auto a : Range(full_dim))
+        for (auto b : Range(a + 1, full_dim)) {
+          set_direction(a, b);
+          expression->Evaluate(mir, ddval);
+          for (auto i : Range(np)) {
+            auto &h = hess[i];
+            h(a, b) = 0.5 * (ddval(0, i).DDValue(0) - h(a, a) - h(b, b));
+            h(b, a) = h(a, b);
+          }
+        }
+    };
+
+    const auto update_active = [&]() -> bool {
+      bool any = false;
+      for (auto i : Range(np)) {
+        active(i) = active_lanes(grad.Col(i), res_0(i), tol, rtol, i * SW, nvalid);
+        any |= HSum(active(i)) > 0;
+      }
+      return any;
+    };
+
+    // backtracking in every active lane until its energy does not increase
+    const auto linesearch = [&]() -> bool {
+      xold = xk;
+      double alpha = 1;
+      double alpha_min = 1e-10;
+      double energy_eps = 1e-10;
+      for (auto i : Range(np))
+        accepted(i) = 1.0 - active(i);
+
+      bool all_accepted = false;
+      while (!all_accepted && alpha > alpha_min) {
+        for (auto i : Range(np))
+          for (auto k : Range(full_dim))
+            xk(k, i) = IfPos(accepted(i) - 0.5, xk(k, i), xold(k, i) - alpha * w(k, i));
+        distribute_xk();
+        calc_energy(newenergy);
+
+        all_accepted = true;
+        for (auto i : Range(np)) {
+          SIMD<double> limit = energy(i) + energy_eps * fabs(energy(i));
+          accepted(i) = SIMD<double>([&](int lane) -> double {
+            return (accepted(i)[lane] > 0.5 || !(newenergy(i)[lane] > limit[lane])) ? 1 : 0;
+          });
+          all_accepted &= HSum(accepted(i)) == SW;
+        }
+        alpha /= 2;
+      }
+      return all_accepted;
+    };
+
+    // Evaluate starting point
+    if (startingpoints.Size() == proxies.Size()) {
+      size_t offset = 0;
+      for (int i : Range(startingpoints)) {
+        startingpoints[i]->Evaluate(mir, xk_blocks[i]);
+        auto next = offset + xk_blocks[i].Height();
+        xk.Rows(offset, next) = xk_blocks[i];
+        offset = next;
+      }
+    } else {
+      assert(startingpoints.Size() == 1);
+      startingpoints[0]->Evaluate(mir, xk);
+      distribute_xk();
+    }
+
+    calc_energy_grad_and_diags();
+    for (auto i : Range(np))
+      res_0(i) = lane_norms(grad.Col(i));
+
+    bool any_active = update_active();
+    for ([[maybe_unused]] int step : Range(maxiter)) {
+      if (!any_active)
+        break;
+
+      {
+        RegionTimer regtr1(t1);
+        calc_off_diagonals();
+      }
+
+      {
+        RegionTimer regtr2(t2);
+        for (auto i : Range(np)) {
+          if (HSum(active(i)) == 0) {
+            w.Col(i) = SIMD<double>(0.0);
+            continue;
+          }
+          lhs = hess[i];
+          rhs = grad.Col(i);
+          SolveSIMD(lhs, rhs);
+          for (auto k : Range(full_dim))
+            w(k, i) = IfPos(active(i) - 0.5, rhs(k), SIMD<double>(0.0));
+        }
+      }
+
+      if (!linesearch())
+        break;
+      calc_energy_grad_and_diags();
+      any_active = update_active();
+    }
+
+    if (any_active) {
+      cout << IM(4) << "The MinimizationCF did not converge to tolerance on element " << trafo.GetElementNr() << endl;
+      if (!allow_fail)
+        xk = SIMD<double>(numeric_limits<double>::quiet_NaN());
+    }
+
+    values.AddSize(full_dim, np) = xk;
+  }
 };
 
 shared_ptr<CoefficientFunction>
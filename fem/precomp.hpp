@@ -57,4 +57,114 @@ public:
 };
 
 
+
+
+
+/*
+  Shape functions and reference gradients of one element class
+  (orientation class, order) tabulated on a SIMD integration rule.
+  shapes(i,k) is shape i in SIMD-point k, dshapes(i,d*nip+k) its d-th
+  reference derivative. Evaluation and transposed evaluation run along
+  contiguous rows.
+*/
+template <int DIM>
+class PrecomputedSIMDShapes
+{
+public:
+  int classnr;
+  int order;
+  INT<DIM> order_inner;
+  Array<SIMD<double>> refpts;
+  Matrix<SIMD<double>> shapes;
+  Matrix<SIMD<double>> dshapes;
+  PrecomputedSIMDShapes * next = nullptr;
+
+  PrecomputedSIMDShapes (int aclassnr, int aorder, INT<DIM> aorder_inner,
+                         const SIMD_IntegrationRule & ir, size_t ndof)
+    : classnr(aclassnr), order(aorder), order_inner(aorder_inner),
+      refpts(DIM*ir.Size()), shapes(ndof, ir.Size()), dshapes(ndof, DIM*ir.Size())
+  {
+    for (size_t i = 0, ii = 0; i < ir.Size(); i++)
+      for (int j = 0; j < DIM; j++, ii++)
+        refpts[ii] = ir[i](j);
+  }
+
+  bool Matches (int aclassnr, int aorder, INT<DIM> aorder_inner,
+                const SIMD_IntegrationRule & ir) const
+  {
+    if (classnr != aclassnr || order != aorder || shapes.Width() != ir.Size())
+      return false;
+    for (int j = 0; j < DIM; j++)
+      if (order_inner[j] != aorder_inner[j]) return false;
+    for (size_t i = 0, ii = 0; i < ir.Size(); i++)
+      for (int j = 0; j < DIM; j++, ii++)
+        if (memcmp (&refpts[ii], &ir[i](j), sizeof(SIMD<double>)) != 0)
+          return false;
+    return true;
+  }
+};
+
+
+/*
+  Thread-safe container of PrecomputedSIMDShapes. Entries are 
+  prepended lock-free to hash buckets and live until the container
+  is destroyed. At most maxentries tables are stored.
+ */
+template <int DIM>
+class PrecomputedSIMDShapesContainer
+{
+  static constexpr size_t NBUCKETS = 64;
+  atomic<PrecomputedSIMDShapes<DIM>*> buckets[NBUCKETS];
+  atomic<size_t> nentries;
+  size_t maxentries;
+
+  static size_t Bucket (int classnr, int order, size_t nip)
+  { return (classnr + 32*order + 7*nip) % NBUCKETS; }
+  
+public:
+  PrecomputedSIMDShapesContainer (size_t amaxentries = 256)
+    : nentries(0), maxentries(amaxentries)
+  {
+    for (auto & b : buckets) b = nullptr;
+  }
+
+  ~PrecomputedSIMDShapesContainer ()
+  {
+    for (auto & b : buckets)
+      for (auto pre = b.load(); pre; )
+        {
+          auto next = pre->next;
+          delete pre;
+          pre = next;
+        }
+  }
+
+  bool Full () const { return nentries >= maxentries; }
+  
+  const PrecomputedSIMDShapes<DIM> * Get (int classnr, int order, INT<DIM> order_inner,
+                                          const SIMD_IntegrationRule & ir) const
+  {
+    for (auto pre = buckets[Bucket(classnr, order, ir.Size())].load(); pre; pre = pre->next)
+      if (pre->Matches (classnr, order, order_inner, ir))
+        return pre;
+    return nullptr;
+  }
+
+  // concurrently added tables for the same key are harmless duplicates
+  const PrecomputedSIMDShapes<DIM> * Add (PrecomputedSIMDShapes<DIM> * pre)
+  {
+    nentries++;
+    auto & head = buckets[Bucket(pre->classnr, pre->order, pre->shapes.Width())];
+    auto old = head.load();
+    do
+      pre->next = old;
+    while (!head.compare_exchange_weak (old, pre));
+    return pre;
+  }
+};
+
+/// high order elements tabulate SIMD shapes from this order on
+constexpr int PRECOMPUTED_SIMD_SHAPES_MINORDER = 5;
+
+
 }
@@ -898,7 +898,7 @@ namespace ngfem
                        FlatVector<SCAL> elvec,
                        LocalHeap & lh) const
   {
-    // static Timer t("symbolicLFI - CalcElementVector", NoTracing); RegionTimer reg(t);
+    static Timer t("symbolicLFI - CalcElementVector", NoTracing); TraceRegion tr(t);
     
     HeapReset hr(lh);
     IntegrationRule ir(trafo.GetElementType(), 2*fel.Order());
@@ -1460,7 +1460,7 @@ namespace ngfem
 //    static Timer tdmat("SymbolicBFI::CalcDMat - simd", NoTracing);
 //    static Timer tmult("SymbolicBFI::mult - simd", NoTracing);
     RegionTimer reg(t);
-    // RegionTracer regtr(TaskManager::GetThreadId(), t);    
+    TraceRegion tr(t);
 
     auto save_userdata = trafo.PushUserData(); 
     
@@ -4233,6 +4233,200 @@ namespace ngfem
   }
 
 
+  bool SymbolicFacetBilinearFormIntegrator ::
+  ApplyFacetMatrixBatch (const FiniteElement & fel1, int LocalFacetNr1,
+                         FlatArray<const ElementTransformation*> trafos1, FlatArray<int> & ElVertices1,
+                         const FiniteElement & fel2, int LocalFacetNr2,
+                         FlatArray<const ElementTransformation*> trafos2, FlatArray<int> & ElVertices2,
+                         FlatMatrix<double> elx, FlatMatrix<double> ely,
+                         LocalHeap & lh) const
+  {
+    // The SIMD lanes hold the same reference point on different facets.
+    // Gridfunctions and cached CFs are evaluated per element, second
+    // derivatives need the mapping of one element: these go facet by facet.
+    if (!simd_evaluate || gridfunction_cfs.Size() || cache_cfs.Size()) return false;
+    if (typeid(fel1) == typeid(const MixedFiniteElement&) ||
+        typeid(fel2) == typeid(const MixedFiniteElement&)) return false;
+    for (auto proxies : { &trial_proxies, &test_proxies })
+      for (ProxyFunction * proxy : *proxies)
+        if (proxy->Evaluator()->DiffOrder() > 1 || proxy->Evaluator()->BlockDim() != 1)
+          return false;
+
+    auto eltype1 = trafos1[0]->GetElementType();
+    auto eltype2 = trafos2[0]->GetElementType();
+    int dim = ElementTopology::GetSpaceDim (eltype1);
+    if (dim < 1 || trafos1[0]->SpaceDim() != dim || trafos2[0]->SpaceDim() != dim)
+      return false;
+
+    static Timer t("SymbolicFacetBFI::ApplyBatch", NoTracing);
+    RegionTimer reg(t);
+    HeapReset hr(lh);
+
+    constexpr size_t W = SIMD<double>::Size();
+    size_t nfacets = elx.Height();
+    size_t ndof1 = fel1.GetNDof();
+    int maxorder = max2 (fel1.Order(), fel2.Order());
+    auto etfacet = ElementTopology::GetFacetType (eltype1, LocalFacetNr1);
+
+    // reference points and trace shapes are the same for all facets of the batch
+    const IntegrationRule & ir_facet = GetIntegrationRule(etfacet, 2*maxorder+bonus_intorder);
+    Facet2ElementTrafo transform1(eltype1, ElVertices1);
+    Facet2ElementTrafo transform2(eltype2, ElVertices2);
+    IntegrationRule & ir_facet_vol1 = transform1(LocalFacetNr1, ir_facet, lh);
+    IntegrationRule & ir_facet_vol2 = transform2(LocalFacetNr2, ir_facet, lh);
+    size_t nip = ir_facet.Size();
+
+    // SIMD point q is reference point q in every lane, lane l is facet l of a chunk
+    SIMD_IntegrationRule simd_ir1(nip*W, lh), simd_ir2(nip*W, lh);
+    for (size_t q = 0; q < nip; q++)
+      {
+        simd_ir1[q] = SIMD<IntegrationPoint> ([&] (int) { return ir_facet_vol1[q]; });
+        simd_ir1[q].SetFacetNr (ir_facet_vol1[q].FacetNr(), ir_facet_vol1[q].VB());
+        simd_ir2[q] = SIMD<IntegrationPoint> ([&] (int) { return ir_facet_vol2[q]; });
+        simd_ir2[q].SetFacetNr (ir_facet_vol2[q].FacetNr(), ir_facet_vol2[q].VB());
+      }
+
+    ely = 0.0;
+    bool ok = true;
+    Switch<3>
+      (dim-1, [&] (auto DIMm1)
+       {
+         constexpr int D = DIMm1.value+1;
+         try
+           {
+             ProxyUserData ud(trial_proxies.Size(), 0, lh);
+             ud.fel = &fel1;   // necessary to check remember-map
+             for (ProxyFunction * proxy : trial_proxies)
+               ud.AssignMemory (proxy, simd_ir1.GetNIP(), proxy->Dimension(), lh);
+
+             Array<MappedIntegrationRule<D,D>*> lane_mir1(W, lh), lane_mir2(W, lh);
+
+             for (size_t first = 0; first < nfacets; first += W)
+               {
+                 HeapReset hr(lh);
+                 size_t nl = min2 (W, nfacets-first);
+                 // lanes beyond the batch repeat its last facet
+                 auto facet = [first,nl] (size_t l) { return first + min2 (l, nl-1); };
+
+                 for (size_t l = 0; l < W; l++)
+                   if (l < nl)
+                     {
+                       lane_mir1[l] = new (lh) MappedIntegrationRule<D,D> (ir_facet_vol1, *trafos1[first+l], lh);
+                       lane_mir2[l] = new (lh) MappedIntegrationRule<D,D> (ir_facet_vol2, *trafos2[first+l], lh);
+                     }
+                   else
+                     {
+                       lane_mir1[l] = lane_mir1[nl-1];
+                       lane_mir2[l] = lane_mir2[nl-1];
+                     }
+
+                 auto & trafo1 = *trafos1[first];
+                 auto & trafo2 = *trafos2[first];
+                 SIMD_MappedIntegrationRule<D,D> simd_mir1(simd_ir1, trafo1, -1, lh);
+                 SIMD_MappedIntegrationRule<D,D> simd_mir2(simd_ir2, trafo2, -1, lh);
+                 for (size_t q = 0; q < nip; q++)
+                   {
+                     for (int i = 0; i < D; i++)
+                       {
+                         simd_mir1[q].Point()(i) = [&] (int l) { return (*lane_mir1[l])[q].GetPoint()(i); };
+                         simd_mir2[q].Point()(i) = [&] (int l) { return (*lane_mir2[l])[q].GetPoint()(i); };
+                         for (int j = 0; j < D; j++)
+                           {
+                             simd_mir1[q].Jacobian()(i,j) = [&] (int l) { return (*lane_mir1[l])[q].GetJacobian()(i,j); };
+                             simd_mir2[q].Jacobian()(i,j) = [&] (int l) { return (*lane_mir2[l])[q].GetJacobian()(i,j); };
+                           }
+                       }
+                     simd_mir1[q].Compute();
+                     simd_mir2[q].Compute();
+                   }
+
+                 simd_mir1.SetOtherMIR(&simd_mir2);
+                 simd_mir2.SetOtherMIR(&simd_mir1);
+                 simd_mir1.ComputeNormalsAndMeasure(eltype1, LocalFacetNr1);
+                 simd_mir2.ComputeNormalsAndMeasure(eltype2, LocalFacetNr2);
+
+                 const_cast<ElementTransformation&>(trafo1).userdata = &ud;
+
+                 // proxy values of all lanes from the trace shapes of the chunk
+                 for (ProxyFunction * proxy : trial_proxies)
+                   {
+                     HeapReset hr(lh);
+                     const FiniteElement & fel = proxy->IsOther() ? fel2 : fel1;
+                     auto & simd_mir = proxy->IsOther() ? simd_mir2 : simd_mir1;
+                     size_t offset = proxy->IsOther() ? ndof1 : 0;
+                     size_t dimp = proxy->Dimension();
+
+                     FlatMatrix<SIMD<double>> bmat(fel.GetNDof()*dimp, nip, lh);
+                     proxy->Evaluator()->CalcMatrix (fel, simd_mir, bmat);
+                     FlatVector<SIMD<double>> coefs(fel.GetNDof(), lh);
+                     for (size_t i = 0; i < coefs.Size(); i++)
+                       coefs(i) = [&] (int l) { return elx(facet(l), offset+i); };
+
+                     auto values = ud.GetAMemory(proxy);
+                     IntRange used = proxy->Evaluator()->UsedDofs(fel);
+                     for (size_t k = 0; k < dimp; k++)
+                       for (size_t q = 0; q < nip; q++)
+                         {
+                           SIMD<double> sum(0.0);
+                           for (size_t i : used)
+                             sum += coefs(i) * bmat(i*dimp+k, q);
+                           values(k,q) = sum;
+                         }
+                   }
+
+                 for (auto i : Range(test_proxies))
+                   {
+                     auto proxy = test_proxies[i];
+                     HeapReset hr(lh);
+                     size_t dimp = proxy->Dimension();
+                     FlatMatrix<SIMD<double>> simd_proxyvalues(dimp, nip, lh);
+
+                     if (dcf_dtest[i])
+                       dcf_dtest[i]->Evaluate (simd_mir1, simd_proxyvalues);
+                     else
+                       for (size_t k = 0; k < dimp; k++)
+                         {
+                           ud.testfunction = proxy;
+                           ud.test_comp = k;
+                           cf -> Evaluate (simd_mir1, simd_proxyvalues.Rows(k,k+1));
+                         }
+
+                     for (size_t k = 0; k < dimp; k++)
+                       for (size_t q = 0; q < nip; q++)
+                         simd_proxyvalues(k,q) *= simd_mir1[q].GetMeasure() * ir_facet[q].Weight();
+
+                     const FiniteElement & fel = proxy->IsOther() ? fel2 : fel1;
+                     auto & simd_mir = proxy->IsOther() ? simd_mir2 : simd_mir1;
+                     size_t offset = proxy->IsOther() ? ndof1 : 0;
+
+                     FlatMatrix<SIMD<double>> bmat(fel.GetNDof()*dimp, nip, lh);
+                     proxy->Evaluator()->CalcMatrix (fel, simd_mir, bmat);
+                     for (size_t j : proxy->Evaluator()->UsedDofs(fel))
+                       {
+                         SIMD<double> sum(0.0);
+                         for (size_t k = 0; k < dimp; k++)
+                           for (size_t q = 0; q < nip; q++)
+                             sum += bmat(j*dimp+k, q) * simd_proxyvalues(k,q);
+                         for (size_t l = 0; l < nl; l++)
+                           ely(first+l, offset+j) += sum[l];
+                       }
+                   }
+               }
+           }
+         catch (const ExceptionNOSIMD& e)
+           {
+             cout << IM(6) << "caught in SymbolicFacetInegtrator::ApplyBatch: " << endl
+                  << e.What() << endl;
+             simd_evaluate = false;
+             ok = false;
+           }
+       });
+
+    if (!ok) ely = 0.0;
+    return ok;
+  }
+
+
   void SymbolicFacetBilinearFormIntegrator :: 
   CalcTraceValues (const FiniteElement & volumefel, int LocalFacetNr,
 		   const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
@@ -953,6 +953,14 @@ public:
                       FlatVector<double> elx, FlatVector<double> ely,
                       LocalHeap & lh) const;
 
+    NGS_DLL_HEADER virtual bool
+    ApplyFacetMatrixBatch (const FiniteElement & volumefel1, int LocalFacetNr1,
+                           FlatArray<const ElementTransformation*> eltrans1, FlatArray<int> & ElVertices1,
+                           const FiniteElement & volumefel2, int LocalFacetNr2,
+                           FlatArray<const ElementTransformation*> eltrans2, FlatArray<int> & ElVertices2,
+                           FlatMatrix<double> elx, FlatMatrix<double> ely,
+                           LocalHeap & lh) const override;
+
     NGS_DLL_HEADER virtual void
     CalcTraceValues (const FiniteElement & volumefel, int LocalFacetNr,
 		     const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
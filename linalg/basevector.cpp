@@ -908,13 +908,61 @@ namespace ngla
     return *this;
   }
   
+  static bool GetNumaInterleaveEnv ()
+  {
+    auto env = getenv ("NGS_NUMA_INTERLEAVE");
+    return env && atoi(env) != 0;
+  }
+  
+  bool numa_interleave = GetNumaInterleaveEnv();
+
+  template <typename TSCAL>
+  void S_BaseVectorPtr<TSCAL> :: AllocateMemory (size_t n, const Partitioning * part)
+  {
+    if (numa_interleave && n > 0)
+      {
+        numa_mem = make_shared<NumaInterleavedArray<TSCAL>> (n);
+        pdata = numa_mem->Data();
+        return;
+      }
+
+    pdata = new TSCAL[n];
+    if (n < 16384) return;   // small vectors stay in cache
+
+    // first touch: pages are mapped on the NUMA node of the writing thread
+    TSCAL * hp = pdata;
+    size_t hes = es;
+    if (part && part->Size() > 0 && (*part)[part->Size()-1].Next()*hes == n)
+      ParallelForRange (*part, [hp, hes] (IntRange r)
+                        {
+                          for (size_t i = r.First()*hes; i < r.Next()*hes; i++)
+                            hp[i] = TSCAL(0);
+                        });
+    else
+      ParallelForRange (n, [hp] (IntRange r)
+                        {
+                          for (auto i : r)
+                            hp[i] = TSCAL(0);
+                        });
+  }
+
+  template <typename TSCAL>
+  void S_BaseVectorPtr<TSCAL> :: FreeMemory ()
+  {
+    if (numa_mem)
+      numa_mem = nullptr;
+    else
+      delete [] pdata;
+    pdata = nullptr;
+  }
+
   template <typename TSCAL>
   S_BaseVectorPtr<TSCAL> :: ~S_BaseVectorPtr ()
   {
     if (ownmem)
       {
         GetMemoryTracer().Free(sizeof(TSCAL) * this->entrysize * this->size);
-        delete [] pdata;
+        FreeMemory();
       }
   }
 
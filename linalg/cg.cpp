@@ -1315,6 +1315,167 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   
  
   
+  /*
+    Breakdown-free block PCG (Ji, Li, 2017): in every step the search
+    directions are A-orthonormalized, directions of a numerically singular
+    block P^T A P are dropped. Then alpha = P^T R and beta = -(AP)^T Z,
+    no further block-inverses are needed.
+   */
+  int BlockCG (const BaseMatrix & mat, const BaseMatrix & pre,
+               const MultiVector & rhs, MultiVector & sol,
+               double tol, int maxsteps, bool initialize, int printrates)
+  {
+    static Timer t("BlockCG");
+    static Timer tmat("BlockCG - matrix");
+    static Timer tpre("BlockCG - preconditioner");
+    static Timer tdense("BlockCG - block operations");
+    RegionTimer reg(t);
+
+    if (rhs.IsComplex())
+      throw Exception ("BlockCG: only real symmetric problems are supported");
+    
+    size_t s = rhs.Size();
+    if (sol.Size() != s)
+      throw Exception ("BlockCG: rhs and sol have different number of vectors");
+    if (s == 0) return 0;
+
+    auto refvec = rhs.RefVec();
+    auto r = refvec->CreateMultiVector(s);
+    auto z = refvec->CreateMultiVector(s);
+    auto p = refvec->CreateMultiVector(s);
+    auto q = refvec->CreateMultiVector(s);
+    auto hp = refvec->CreateMultiVector(s);
+    auto hq = refvec->CreateMultiVector(s);
+
+    Vector<double> ones(s), mones(s);
+    ones = 1.0;
+    mones = -1.0;
+    
+    *r = rhs;
+    if (initialize)
+      sol = 0.0;
+    else
+      {
+        RegionTimer regm(tmat);
+        mat.MultAdd (mones, sol, *r);
+      }
+
+    {
+      RegionTimer regp(tpre);
+      *z = 0.0;
+      pre.MultAdd (ones, *r, *z);
+    }
+    *p = *z;
+
+    // preconditioned residual norms of the individual right hand sides
+    auto Errors = [&] ()
+      {
+        Vector<double> err(s);
+        for (size_t i = 0; i < s; i++)
+          err(i) = sqrt (fabs ((*r)[i]->InnerProductD(*(*z)[i])));
+        return err;
+      };
+
+    Vector<double> err0 = Errors();
+    if (printrates) cout << IM(1) << "0 " << L2Norm(err0) << endl;
+
+    auto Converged = [&] (FlatVector<double> err)
+      {
+        for (size_t i = 0; i < s; i++)
+          if (err(i) > tol * err0(i)) return false;
+        return true;
+      };
+    
+    if (Converged(err0)) return 0;
+
+    int steps = 0;
+    while (steps < maxsteps)
+      {
+        steps++;
+
+        {
+          RegionTimer regm(tmat);
+          *q = 0.0;
+          mat.MultAdd (ones, *p, *q);
+        }
+
+        Matrix<double> alpha, beta;
+        int k = 0;
+        {
+          RegionTimer regd(tdense);
+          
+          // A-orthonormalize search directions, drop dependent ones
+          Matrix<double> pq = p->InnerProductD(*q);
+          Matrix<double> gram = 0.5 * (pq + Trans(pq));
+          Vector<double> lami(s);
+          Matrix<double> evecs(s,s);
+#ifdef LAPACK
+          LapackEigenValuesSymmetric (gram, lami, evecs);
+#else
+          FlatVector<double> flami = lami;
+          FlatMatrix<double> fevecs = evecs;
+          CalcEigenSystem (gram, flami, fevecs);
+#endif
+          double lammax = 0;
+          for (size_t i = 0; i < s; i++)
+            lammax = max2 (lammax, lami(i));
+          
+          Array<int> keep;
+          for (size_t i = 0; i < s; i++)
+            if (lami(i) > 1e-14 * lammax)
+              keep.Append(i);
+          k = keep.Size();
+          if (k == 0) break;
+          
+          Matrix<double> w(s, k);
+          for (int j = 0; j < k; j++)
+            w.Col(j) = 1.0/sqrt(lami(keep[j])) * evecs.Row(keep[j]);
+
+          auto pk = hp->Range(IntRange(0,k));
+          auto qk = hq->Range(IntRange(0,k));
+          *pk = 0.0;
+          pk->Add (*p, w);
+          *qk = 0.0;
+          qk->Add (*q, w);
+          
+          // sol += P alpha, r -= AP alpha
+          alpha = r->InnerProductD(*pk);
+          sol.Add (*pk, alpha);
+          Matrix<double> malpha = -alpha;
+          r->Add (*qk, malpha);
+
+          swap (p, hp);
+          swap (q, hq);
+        }
+
+        {
+          RegionTimer regp(tpre);
+          *z = 0.0;
+          pre.MultAdd (ones, *r, *z);
+        }
+
+        Vector<double> err = Errors();
+        if (printrates) cout << IM(1) << steps << " " << L2Norm(err) << endl;
+        if (Converged(err)) break;
+
+        {
+          RegionTimer regd(tdense);
+          auto pk = p->Range(IntRange(0,k));
+          auto qk = q->Range(IntRange(0,k));
+          
+          // P = Z + P beta,  beta = -(AP)^T Z
+          beta = z->InnerProductD(*qk);
+          beta *= -1;
+          *hp = *z;
+          hp->Add (*pk, beta);
+          swap (p, hp);
+        }
+      }
+    
+    return steps;
+  }
+  
+
   template class CGSolver<double>;
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
@@ -128,6 +128,19 @@ namespace ngla
   };
 
 
+  /**
+     Block preconditioned conjugate gradient method for several right hand
+     sides with the same symmetric positive definite matrix. The matrix
+     and the preconditioner are applied to the whole block at once.
+     Stops if the preconditioned residual of every right hand side is
+     reduced by tol. Returns the number of iterations.
+   */
+  NGS_DLL_HEADER int BlockCG (const BaseMatrix & mat, const BaseMatrix & pre,
+                              const MultiVector & rhs, MultiVector & sol,
+                              double tol = 1e-12, int maxsteps = 200,
+                              bool initialize = true, int printrates = 0);
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
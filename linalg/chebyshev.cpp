@@ -78,4 +78,36 @@ namespace ngla
 	  }
       }
   }
+
+
+  double EstimateLargestEigenvalue (const BaseMatrix & a, const BaseMatrix & c, int steps)
+  {
+    static Timer t("EstimateLargestEigenvalue"); RegionTimer reg(t);
+    
+    auto x = a.CreateColVector();
+    auto ax = a.CreateColVector();
+    auto cax = a.CreateColVector();
+
+    // start vector in the range of c (e.g. only free dofs)
+    ax.SetRandom();
+    c.Mult (ax, x);
+
+    double lam = 0;
+    for (int i = 0; i < steps; i++)
+      {
+        a.Mult (x, ax);
+        double xax = x.InnerProductD (ax);
+        if (xax <= 0) break;
+        
+        c.Mult (ax, cax);
+        double caxax = cax.InnerProductD (ax);
+        // Rayleigh quotient of c*a in the a-inner product
+        lam = caxax / xax;
+        if (caxax <= 0) break;
+        
+        x = cax;
+        x *= 1/sqrt(caxax);
+      }
+    return lam;
+  }
 }
@@ -36,6 +36,14 @@ namespace ngla
     AutoVector CreateColVector () const override { return a->CreateRowVector(); }
   };
 
+
+  /**
+     Estimate the largest eigenvalue of c*a by power iteration.
+     a and c are assumed to be symmetric, a positive definite.
+  */
+  NGS_DLL_HEADER double EstimateLargestEigenvalue (const BaseMatrix & a, const BaseMatrix & c,
+                                                   int steps = 20);
+
 }
 
 #endif
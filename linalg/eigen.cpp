@@ -292,4 +292,257 @@ namespace ngla
       ost << "lam(" << i << ") = " << EigenValue(i) << endl;
   }
 
+  // eigen decomposition of the symmetric part, eigenvectors are the rows of evecs
+  static void SymmetricEigenSystem (FlatMatrix<double> mat, FlatVector<double> lami, FlatMatrix<double> evecs)
+  {
+    Matrix<double> sym = 0.5 * (mat + Trans(mat));
+#ifdef LAPACK
+    LapackEigenValuesSymmetric (sym, lami, evecs);
+#else
+    CalcEigenSystem (sym, lami, evecs);
+#endif
+  }
+
+  Vector<double> KrylovSchur (const BaseMatrix & mass, const BaseMatrix & shiftinv,
+                              double shift, const MultiVector & start,
+                              MultiVector & evecs, int nev,
+                              double tol, int maxrestarts, int ncv, int printrates)
+  {
+    static Timer t("KrylovSchur");
+    static Timer tinv("KrylovSchur - shift-inverse");
+    static Timer tmass("KrylovSchur - mass");
+    static Timer torth("KrylovSchur - orthogonalization");
+    static Timer tdense("KrylovSchur - Rayleigh-Ritz");
+    RegionTimer reg(t);
+
+    if (start.IsComplex())
+      throw Exception ("KrylovSchur: only real symmetric problems are supported");
+    
+    int b = start.Size();
+    if (b == 0)
+      throw Exception ("KrylovSchur: empty start block");
+    if (evecs.Size() < nev)
+      throw Exception ("KrylovSchur: evecs needs nev vectors");
+    
+    int m = ncv;
+    if (m == 0) m = max2 (2*nev, nev+2*b);
+    if (m < nev+b)
+      throw Exception ("KrylovSchur: ncv must be at least nev + blocksize");
+
+    auto refvec = start.RefVec();
+    auto V = refvec->CreateMultiVector(m);
+    auto Vtmp = refvec->CreateMultiVector(m);
+    auto f = refvec->CreateMultiVector(b);
+    auto w = refvec->CreateMultiVector(b);
+    auto mw = refvec->CreateMultiVector(b);
+
+    Vector<double> ones(b);
+    ones = 1.0;
+
+    auto ApplyMass = [&] (const MultiVector & x, MultiVector & y)
+      {
+        RegionTimer regm(tmass);
+        y = 0.0;
+        mass.MultAdd (ones.Range(0,x.Size()), x, y);
+      };
+    
+    /*
+      M-orthogonalizes x against the first j vectors of V (twice),
+      and M-orthonormalizes x itself: x_in = V h + x_out R.
+      Numerically dependent directions are replaced by random vectors.
+     */
+    auto Orthonormalize = [&] (MultiVector & x, int j, FlatMatrix<double> h, FlatMatrix<double> r)
+      {
+        RegionTimer rego(torth);
+        h = 0.0;
+        auto Vj = V->Range(IntRange(0,j));
+        auto Project = [&] (MultiVector & y, FlatMatrix<double> hy)
+          {
+            if (j == 0) return;
+            auto my = mw->Range(IntRange(0,y.Size()));
+            ApplyMass (y, *my);
+            Matrix<double> hi = my->InnerProductD(*Vj);
+            hy += hi;
+            Matrix<double> mhi = -hi;
+            y.Add (*Vj, mhi);
+          };
+        
+        for (int k = 0; k < 2; k++)
+          Project (x, h);
+
+        ApplyMass (x, *mw);
+        Matrix<double> gram = mw->InnerProductD(x);
+        Vector<double> lami(b);
+        Matrix<double> ev(b,b);
+        SymmetricEigenSystem (gram, lami, ev);
+
+        double lammax = 0;
+        for (int i = 0; i < b; i++)
+          lammax = max2 (lammax, lami(i));
+
+        // x U Lam^{-1/2}, sorted such that the good directions come first
+        Array<int> good, bad;
+        for (int i = b-1; i >= 0; i--)
+          if (lami(i) > 1e-14 * lammax && lammax > 0)
+            good.Append(i);
+          else
+            bad.Append(i);
+        
+        Matrix<double> trafo(b,b);
+        trafo = 0.0;
+        r = 0.0;
+        for (int i = 0; i < good.Size(); i++)
+          {
+            trafo.Col(i) = 1.0/sqrt(lami(good[i])) * ev.Row(good[i]);
+            r.Row(i) = sqrt(lami(good[i])) * ev.Row(good[i]);
+          }
+        *w = 0.0;
+        w->Add (x, trafo);
+        x = *w;
+
+        // replace lost directions by random ones, orthogonal to V and the good ones
+        for (int i = good.Size(); i < b; i++)
+          {
+            auto xi = x.Range(IntRange(i,i+1));
+            auto xprev = x.Range(IntRange(0,i));
+            (*xi)[0]->SetRandom();
+            for (int k = 0; k < 2; k++)
+              {
+                Matrix<double> dummy(j,1);
+                dummy = 0.0;
+                Project (*xi, dummy);
+                if (i > 0)
+                  {
+                    auto mxi = mw->Range(IntRange(0,1));
+                    ApplyMass (*xi, *mxi);
+                    Matrix<double> hi = mxi->InnerProductD(*xprev);
+                    Matrix<double> mhi = -hi;
+                    xi->Add (*xprev, mhi);
+                  }
+              }
+            auto mxi = mw->Range(IntRange(0,1));
+            ApplyMass (*xi, *mxi);
+            double nrm = sqrt ((*mxi)[0]->InnerProductD(*(*xi)[0]));
+            *(*xi)[0] *= 1.0/nrm;
+          }
+      };
+
+    Matrix<double> T(m,m), B(b,m);
+    T = 0.0;
+    B = 0.0;
+    Matrix<double> h(m,b), r(b,b);
+    
+    *f = start;
+    Orthonormalize (*f, 0, h.Rows(0,0), r);
+
+    int j = 0;
+    int nconv = 0;
+    Vector<double> theta;
+    Matrix<double> Y;
+    Array<int> order;
+    
+    for (int restart = 0; restart <= maxrestarts; restart++)
+      {
+        // expand Krylov space:  Op V = V T + f B
+        while (j + b <= m)
+          {
+            auto Vnew = V->Range(IntRange(j,j+b));
+            *Vnew = *f;
+            j += b;
+
+            ApplyMass (*f, *mw);
+            {
+              RegionTimer regi(tinv);
+              *f = 0.0;
+              shiftinv.MultAdd (ones, *mw, *f);
+            }
+
+            Orthonormalize (*f, j, h.Rows(0,j), r);
+            
+            T.Rows(j-b,j).Cols(0,j-b) = B.Cols(0,j-b);
+            T.Rows(0,j).Cols(j-b,j) = h.Rows(0,j);
+            B = 0.0;
+            B.Cols(j-b,j) = r;
+          }
+
+        // Rayleigh-Ritz on the Krylov space
+        RegionTimer regd(tdense);
+        Vector<double> lami(j);
+        Matrix<double> ev(j,j);
+        Matrix<double> Tj = T.Rows(0,j).Cols(0,j);
+        SymmetricEigenSystem (Tj, lami, ev);
+
+        // largest |theta| first, these are the eigenvalues closest to the shift
+        Array<double> key(j);
+        order.SetSize(j);
+        for (int i = 0; i < j; i++)
+          {
+            key[i] = -fabs(lami(i));
+            order[i] = i;
+          }
+        QuickSortI (key, order);
+        
+        theta.SetSize(j);
+        Y.SetSize(j,j);
+        for (int i = 0; i < j; i++)
+          {
+            theta(i) = lami(order[i]);
+            Y.Col(i) = ev.Row(order[i]);
+          }
+
+        // residual of Ritz pair i is || B y_i ||, since f is M-orthonormal
+        Matrix<double> by = B.Cols(0,j) * Y;
+        nconv = 0;
+        while (nconv < nev && L2Norm(by.Col(nconv)) <= tol * fabs(theta(nconv)))
+          nconv++;
+
+        if (printrates)
+          cout << IM(1) << "restart " << restart << ", converged " << nconv << "/" << nev
+               << ", residual " << L2Norm(by.Col(min2(nconv,nev-1))) << endl;
+        
+        if (nconv >= nev || restart == maxrestarts) break;
+
+        // thick restart with the k best Ritz vectors
+        int k = min2 (j-b, nev + (j-nev)/2);
+        auto Vk = Vtmp->Range(IntRange(0,k));
+        *Vk = 0.0;
+        Matrix<double> Yk = Y.Cols(0,k);
+        Vk->Add (*V->Range(IntRange(0,j)), Yk);
+        *V->Range(IntRange(0,k)) = *Vk;
+        
+        T = 0.0;
+        for (int i = 0; i < k; i++)
+          T(i,i) = theta(i);
+        Matrix<double> bk = by.Cols(0,k);
+        B = 0.0;
+        B.Cols(0,k) = bk;
+        j = k;
+      }
+
+    if (nconv < nev)
+      cout << IM(1) << "KrylovSchur: only " << nconv << " of " << nev << " eigenvalues converged" << endl;
+
+    // eigenvalues in ascending order
+    Array<double> lam(nev);
+    Array<int> index(nev);
+    for (int i = 0; i < nev; i++)
+      {
+        lam[i] = shift + 1.0/theta(i);
+        index[i] = i;
+      }
+    QuickSortI (lam, index);
+    
+    Matrix<double> Ysort(j, nev);
+    Vector<double> res(nev);
+    for (int i = 0; i < nev; i++)
+      {
+        Ysort.Col(i) = Y.Col(index[i]);
+        res(i) = lam[index[i]];
+      }
+    auto evn = evecs.Range(IntRange(0,nev));
+    *evn = 0.0;
+    evn->Add (*V->Range(IntRange(0,j)), Ysort);
+    return res;
+  }
+
 }
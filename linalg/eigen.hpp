@@ -52,6 +52,30 @@ namespace ngla
     void PrintEigenValues (ostream & ost) const;
   };
 
+
+  /**
+     Block Krylov-Schur eigensolver for the generalized symmetric evp
+
+     A x = lam M x
+
+     using shift-and-invert: the Krylov space is built by the operator
+     (A - shift M)^{-1} M, given by shiftinv and mass, in the M-inner product.
+     The block size is the number of vectors in start, the Krylov space
+     is restarted (thick restart) with the best Ritz vectors whenever it
+     reaches ncv vectors.
+
+     All vector operations work on MultiVectors, so they are thread- and,
+     for parallel vectors, MPI-parallel.
+
+     Returns the nev eigenvalues closest to shift in ascending order,
+     the eigenvectors are stored in evecs (which needs nev vectors).
+  */
+  NGS_DLL_HEADER Vector<double> KrylovSchur (const BaseMatrix & mass, const BaseMatrix & shiftinv,
+                                             double shift, const MultiVector & start,
+                                             MultiVector & evecs, int nev,
+                                             double tol = 1e-10, int maxrestarts = 100,
+                                             int ncv = 0, int printrates = 0);
+
 }
 
 #endif
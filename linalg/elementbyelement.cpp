@@ -160,7 +160,7 @@ namespace ngla
   template <class SCAL>
   ElementByElementMatrix<SCAL> :: ~ElementByElementMatrix ()
   {
-    if (allvalues.Size())
+    if (allvalues.Size() || IsSinglePrecision())
       return;  // all memory in unique_ptrs 
     
     for (int i = 0; i < ne; i++)
@@ -180,6 +180,12 @@ namespace ngla
     static Timer timer("EBE-matrix::MultAdd");
     RegionTimer reg (timer);
 
+    if (IsSinglePrecision())
+      {
+        MultAddSingle (s, x, y, false);
+        return;
+      }
+
     size_t maxs = 0;
     for (size_t i = 0; i < coldnums.Size(); i++)
       maxs = max2 (maxs, coldnums[i].Size());
@@ -245,6 +251,12 @@ namespace ngla
     static Timer timer("EBE-matrix::MultAdd");
     RegionTimer reg (timer);
 
+    if (IsSinglePrecision())
+      {
+        MultAddSingle (s, x, y, false);
+        return;
+      }
+
     size_t maxs = 0;
     for (size_t i = 0; i < coldnums.Size(); i++)
       maxs = max2 (maxs, coldnums[i].Size());
@@ -327,6 +339,13 @@ namespace ngla
 //     cout << " ElementByElementMatrix<SCAL> :: MultTansAdd here " << endl << flush;
     static Timer timer("EBE-matrix::MultTransAdd");
     RegionTimer reg (timer);
+
+    if (IsSinglePrecision())
+      {
+        MultAddSingle (s, x, y, true);
+        return;
+      }
+
     size_t maxs = 0;
     for (size_t i = 0; i < rowdnums.Size(); i++)
       maxs = max2 (maxs, rowdnums[i].Size());
@@ -390,6 +409,13 @@ namespace ngla
   {
     static Timer timer("EBE-matrix<double>::MultTransAdd");
     RegionTimer reg (timer);
+
+    if (IsSinglePrecision())
+      {
+        MultAddSingle (s, x, y, true);
+        return;
+      }
+
     size_t maxs = 0;
     for (size_t i = 0; i < rowdnums.Size(); i++)
       maxs = max2 (maxs, rowdnums[i].Size());
@@ -547,7 +573,7 @@ namespace ngla
       if (coldnums_in[i] >= 0) usedcols.Append(i);
     int sc = usedcols.Size();
 
-    if (allvalues.Size())
+    if (allvalues.Size() || IsSinglePrecision())
       {
         FlatMatrix<SCAL> mat(elmats[elnr]);
         FlatArray<int> dnr(rowdnums[elnr]);
@@ -560,9 +586,17 @@ namespace ngla
                              "dnc.size = "+ToString(dnc.Size()) + " sc = " +ToString(sc));
           }
 
-        for (int i = 0; i < sr; i++)
-          for (int j = 0; j < sc; j++)
-            mat(i,j) = elmat(usedrows[i], usedcols[j]);
+        if (IsSinglePrecision())
+          {
+            TSINGLE * smat = allvalues_single.Addr(first_single[elnr]);
+            for (int i = 0; i < sr; i++)
+              for (int j = 0; j < sc; j++)
+                smat[i*sc+j] = TSINGLE(elmat(usedrows[i], usedcols[j]));
+          }
+        else
+          for (int i = 0; i < sr; i++)
+            for (int j = 0; j < sc; j++)
+              mat(i,j) = elmat(usedrows[i], usedcols[j]);
 
         for (int i = 0; i < sr; i++)
           dnr[i] = rowdnums_in[usedrows[i]];
@@ -602,7 +636,7 @@ namespace ngla
                                                          const FlatArray<int> & coldnums_in,
                                                          int refelnr)
   {
-    if (allvalues.Size())
+    if (allvalues.Size() || IsSinglePrecision())
       throw Exception ("AddClone + allvalues not ready");
 
     ArrayMem<int,50> usedrows;
@@ -654,6 +688,105 @@ namespace ngla
                             clone, "clone");
   }
 
+  template <class SCAL>
+  void ElementByElementMatrix<SCAL> :: CompressToSinglePrecision ()
+  {
+    if (IsSinglePrecision()) return;
+    if (!allvalues.Size())
+      throw Exception ("EBEMatrix::CompressToSinglePrecision needs matrix allocated all at once");
+
+    static Timer t("EBE-matrix::CompressToSinglePrecision");
+    RegionTimer reg(t);
+
+    first_single.SetSize(elmats.Size()+1);
+    size_t totmem = 0;
+    for (size_t i = 0; i < elmats.Size(); i++)
+      {
+        first_single[i] = totmem;
+        totmem += elmats[i].Height()*elmats[i].Width();
+      }
+    first_single[elmats.Size()] = totmem;
+
+    allvalues_single.SetSize(totmem);
+    ParallelForRange (ne, [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          {
+                            FlatMatrix<SCAL> mat = elmats[i];
+                            TSINGLE * smat = allvalues_single.Addr(first_single[i]);
+                            for (size_t j = 0; j < mat.Height(); j++)
+                              for (size_t k = 0; k < mat.Width(); k++)
+                                smat[j*mat.Width()+k] = TSINGLE(mat(j,k));
+                          }
+                      });
+
+    // keep the sizes, the double precision values are released
+    for (size_t i = 0; i < elmats.Size(); i++)
+      elmats[i].AssignMemory (elmats[i].Height(), elmats[i].Width(), nullptr);
+    allvalues = Array<SCAL>();
+    GetMemoryTracer().Track(allvalues_single, "allvalues_single");
+  }
+
+  template <class SCAL>
+  void ElementByElementMatrix<SCAL> :: MultAddSingle (double s, const BaseVector & x, BaseVector & y, bool trans) const
+  {
+    static Timer timer("EBE-matrix::MultAdd single");
+    RegionTimer reg (timer);
+
+    FlatVector<SCAL> vx = x.FV<SCAL> (); 
+    FlatVector<SCAL> vy = y.FV<SCAL> (); 
+    
+    ParallelForRange
+      (ne, [&] (IntRange r)
+       {
+         ArrayMem<SCAL, 100> mem1(max_row_size), mem2(max_col_size);
+         for (size_t i : r)
+           {
+             FlatArray<int> rdi (rowdnums[i]);
+             FlatArray<int> cdi (coldnums[i]);
+             
+             if (!rdi.Size() || !cdi.Size()) continue;
+             if (rdi[0] == -1 || cdi[0] == -1) continue;  // reserved but not used
+
+             size_t h = rdi.Size(), w = cdi.Size();
+             const TSINGLE * smat = allvalues_single.Addr(first_single[i]);
+             FlatVector<SCAL> hvr(h, mem1.Data());
+             FlatVector<SCAL> hvc(w, mem2.Data());
+             
+             if (!trans)
+               {
+                 hvc = vx(cdi);
+                 for (size_t j = 0; j < h; j++)
+                   {
+                     SCAL sum = 0.0;
+                     for (size_t k = 0; k < w; k++)
+                       sum += SCAL(smat[j*w+k]) * hvc(k);
+                     AtomicAdd (vy(rdi[j]), s*sum);
+                   }
+               }
+             else
+               {
+                 hvr = vx(rdi);
+                 hvc = 0.0;
+                 for (size_t j = 0; j < h; j++)
+                   for (size_t k = 0; k < w; k++)
+                     hvc(k) += SCAL(smat[j*w+k]) * hvr(j);
+                 for (size_t k = 0; k < w; k++)
+                   AtomicAdd (vy(cdi[k]), s*hvc(k));
+               }
+             timer.AddFlops (h*w);
+           }
+       });
+  }
+
+  template <class SCAL>
+  Array<MemoryUsage> ElementByElementMatrix<SCAL> :: GetMemoryUsage () const
+  {
+    size_t nbytes = allvalues.Size()*sizeof(SCAL) + allvalues_single.Size()*sizeof(TSINGLE)
+      + (allrow.Size()+allcol.Size())*sizeof(int);
+    return { { IsSinglePrecision() ? "EBE-matrix (single)" : "EBE-matrix", nbytes, 1 } };
+  }
+
   template <class SCAL>
   BaseBlockJacobiPrecond * ElementByElementMatrix<SCAL> :: 
   CreateBlockJacobiPrecond (Table<int> & blocks,
@@ -673,7 +806,10 @@ namespace ngla
 	  ost << "block " << i << endl;
 	  ost << "rows = " << rowdnums[i] << endl;
 	  ost << "cols = " << coldnums[i] << endl;
-	  ost << "matrix = " << elmats[i] << endl;
+          if (IsSinglePrecision())
+            ost << "matrix stored in single precision" << endl;
+          else
+            ost << "matrix = " << elmats[i] << endl;
 	}
       return ost;
     }
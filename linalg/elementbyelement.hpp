@@ -33,6 +33,11 @@ namespace ngla
 
     Array<int> allrow, allcol;
     Array<SCAL> allvalues;
+
+    /// compact storage: element matrices rounded to single precision
+    typedef std::conditional_t<is_same_v<SCAL,Complex>, complex<float>, float> TSINGLE;
+    Array<TSINGLE> allvalues_single;
+    Array<size_t> first_single;
   public:
     ElementByElementMatrix (int h, int ane, bool isymmetric=false);
     ElementByElementMatrix (int h, int w, int ane, bool isymmetric=false);
@@ -64,6 +69,14 @@ namespace ngla
                            FlatArray<int> dnums2,
                            BareSliceMatrix<SCAL> elmat);
 			   
+    /*
+      Converts the stored element matrices to single precision.
+      Halves the memory for the values, products are computed in SCAL.
+      Only for matrices allocated all at once.
+     */
+    void CompressToSinglePrecision ();
+    bool IsSinglePrecision () const { return first_single.Size() > 0; }
+			   
     void AddCloneElementMatrix(int elnr,
                            const FlatArray<int> & dnums1,
 			   const FlatArray<int> & dnums2,
@@ -77,6 +90,8 @@ namespace ngla
 
     const FlatMatrix<SCAL> GetElementMatrix( int elnum ) const
     {
+      if (IsSinglePrecision())
+        throw Exception ("ebe-matrix stored in single precision, no access to element matrix");
       return elmats[elnum];
     }
 
@@ -117,7 +132,10 @@ namespace ngla
     
     size_t NZE () const override { return GetNZE(); }
 
+    Array<MemoryUsage> GetMemoryUsage () const override;
+
   private:
+    void MultAddSingle (double s, const BaseVector & x, BaseVector & y, bool trans) const;
     void InitMemoryTracing() const;
   };  
 
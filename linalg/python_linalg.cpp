@@ -46,6 +46,7 @@ public:
 
   void Mult (const BaseVector & x, BaseVector & y) const override
   {
+    py::gil_scoped_acquire gil;
     shared_ptr<BaseVector> spx(const_cast<BaseVector*>(&x), &NOOP_Deleter);
     py::object pyy = pyop * py::cast(spx);
     auto pyv = py::cast<DynamicVectorExpression> (pyy);
@@ -54,6 +55,7 @@ public:
 
   void MultAdd (double s, const BaseVector & x, BaseVector & y) const override
   {
+    py::gil_scoped_acquire gil;
     shared_ptr<BaseVector> spx(const_cast<BaseVector*>(&x), &NOOP_Deleter);
     py::object pyy = pyop * py::cast(spx);
     auto pyv = py::cast<DynamicVectorExpression> (pyy);
@@ -62,6 +64,153 @@ public:
 };
 
 
+/*
+  Zero-copy views between NGSolve vectors and numpy arrays.
+
+  Exports: the numpy array gets the owning shared_ptr as its base object,
+  the memory stays valid as long as the array lives.
+  Imports: the NGSolve vector references the numpy buffer, its deleter
+  releases the Python object (with the GIL acquired, vectors may be
+  destroyed from worker threads or with released GIL).
+*/
+
+template <typename TSCAL>
+static py::array MakeNumPyView (TSCAL * data, size_t h, size_t w, size_t rowdist, py::handle base)
+{
+  vector<ptrdiff_t> shape { ptrdiff_t(h) };
+  vector<ptrdiff_t> strides { ptrdiff_t(rowdist*sizeof(TSCAL)) };
+  if (w > 1)
+    {
+      shape.push_back (w);
+      strides.push_back (sizeof(TSCAL));
+    }
+  return py::array_t<TSCAL> (shape, strides, data, base);
+}
+
+static py::array VectorNumPy (shared_ptr<BaseVector> vec)
+{
+  py::object base = py::cast(vec);
+  size_t es = vec->EntrySize();
+  if (!vec->IsComplex())
+    return MakeNumPyView (vec->FVDouble().Data(), vec->Size(), es, es, base);
+  es /= 2;
+  return MakeNumPyView (vec->FVComplex().Data(), vec->Size(), es, es, base);
+}
+
+// 2D view (one row per vector), requires vectors of equal layout with constant distance in memory
+static py::array MultiVectorNumPy (const MultiVector & mv)
+{
+  if (mv.Size() == 0)
+    throw Exception ("MultiVector.NumPy: empty MultiVector");
+
+  bool is_complex = mv.IsComplex();
+  size_t scalsize = is_complex ? sizeof(Complex) : sizeof(double);
+  size_t n = mv[0]->Size() * mv[0]->EntrySize() * sizeof(double) / scalsize;
+  auto Addr = [&] (size_t i) -> char*
+    {
+      if (mv[i]->Size() != mv[0]->Size() || mv[i]->EntrySize() != mv[0]->EntrySize())
+        throw Exception ("MultiVector.NumPy: vectors of different size");
+      return is_complex ? (char*)mv[i]->FVComplex().Data() : (char*)mv[i]->FVDouble().Data();
+    };
+
+  char * first = Addr(0);
+  ptrdiff_t dist = (mv.Size() > 1) ? Addr(1)-first : n*scalsize;
+  for (size_t i = 2; i < mv.Size(); i++)
+    if (Addr(i)-first != ptrdiff_t(i)*dist)
+      throw Exception ("MultiVector.NumPy: vectors are not equally spaced in memory, "
+                       "create the MultiVector with contiguous=True");
+  if (dist % ptrdiff_t(scalsize) != 0)
+    throw Exception ("MultiVector.NumPy: misaligned vectors");
+
+  // the capsule keeps the vectors alive, even if they are replaced in the MultiVector
+  auto keep = new Array<shared_ptr<BaseVector>>(mv.Size());
+  for (size_t i = 0; i < mv.Size(); i++)
+    (*keep)[i] = mv[i];
+  py::capsule base(keep, [] (void * p) { delete static_cast<Array<shared_ptr<BaseVector>>*>(p); });
+
+  vector<ptrdiff_t> shape { ptrdiff_t(mv.Size()), ptrdiff_t(n) };
+  vector<ptrdiff_t> strides { dist, ptrdiff_t(scalsize) };
+  if (is_complex)
+    return py::array_t<Complex> (shape, strides, (Complex*)first, base);
+  return py::array_t<double> (shape, strides, (double*)first, base);
+}
+
+// MultiVector with all vectors in one block of memory, allows for a 2D numpy view
+static shared_ptr<MultiVector> CreateContiguousMultiVector (size_t size, size_t cnt, bool is_complex)
+{
+  shared_ptr<BaseVector> storage = CreateBaseVector (size*cnt, is_complex, 1);
+  Array<shared_ptr<BaseVector>> vecs(cnt);
+  auto keep = [storage] (BaseVector * v) { delete v; };
+  for (size_t i = 0; i < cnt; i++)
+    if (is_complex)
+      vecs[i] = shared_ptr<BaseVector> (new VFlatVector<Complex> (size, storage->FVComplex().Data()+i*size), keep);
+    else
+      vecs[i] = shared_ptr<BaseVector> (new VFlatVector<double> (size, storage->FVDouble().Data()+i*size), keep);
+  if (cnt == 0)
+    return make_shared<MultiVector> (size, 0, is_complex);
+  return make_shared<BaseVectorPtrMV> (vecs);
+}
+
+// holds a Python object, releases it with the GIL acquired
+static shared_ptr<py::object> KeepPyObject (py::object obj)
+{
+  return shared_ptr<py::object> (new py::object(obj),
+                                 [] (py::object * o) { py::gil_scoped_acquire gil; delete o; });
+}
+
+template <typename TSCAL>
+static shared_ptr<BaseVector> WrapNumPyBuffer (py::array arr, size_t offset, size_t size,
+                                               shared_ptr<py::object> keep)
+{
+  TSCAL * data = static_cast<TSCAL*> (arr.mutable_data()) + offset;
+  return shared_ptr<BaseVector> (new VFlatVector<TSCAL> (size, data),
+                                 [keep] (BaseVector * v) { delete v; });
+}
+
+template <typename TSCAL>
+static bool IsNumPyWrappable (py::array arr, int ndim)
+{
+  return py::isinstance<py::array_t<TSCAL>>(arr) && arr.ndim() == ndim && arr.writeable()
+    && (arr.flags() & py::array::c_style);
+}
+
+static shared_ptr<BaseVector> VectorFromNumPy (py::array arr)
+{
+  if (IsNumPyWrappable<double>(arr, 1))
+    return WrapNumPyBuffer<double> (arr, 0, arr.shape(0), KeepPyObject(arr));
+  if (IsNumPyWrappable<Complex>(arr, 1))
+    return WrapNumPyBuffer<Complex> (arr, 0, arr.shape(0), KeepPyObject(arr));
+  throw Exception ("BaseVector.FromNumPy: need a writeable, C-contiguous 1D array of float64 or complex128");
+}
+
+static shared_ptr<MultiVector> MultiVectorFromNumPy (py::array arr)
+{
+  bool is_complex = IsNumPyWrappable<Complex>(arr, 2);
+  if (!is_complex && !IsNumPyWrappable<double>(arr, 2))
+    throw Exception ("MultiVector.FromNumPy: need a writeable, C-contiguous 2D array of float64 or complex128");
+  size_t cnt = arr.shape(0), size = arr.shape(1);
+  if (cnt == 0)
+    return make_shared<MultiVector> (size, 0, is_complex);
+  auto keep = KeepPyObject(arr);
+  Array<shared_ptr<BaseVector>> vecs(cnt);
+  for (size_t i = 0; i < cnt; i++)
+    vecs[i] = is_complex ? WrapNumPyBuffer<Complex> (arr, i*size, size, keep)
+      : WrapNumPyBuffer<double> (arr, i*size, size, keep);
+  return make_shared<BaseVectorPtrMV> (vecs);
+}
+
+// __array__ protocol, numpy >= 2 passes the copy argument
+static py::object ArrayProtocol (py::array view, py::object dtype, py::object copy)
+{
+  py::object res = view;
+  if (!dtype.is_none())
+    res = view.attr("astype")(dtype, py::arg("copy")=false);
+  if (!copy.is_none() && py::cast<bool>(copy) && res.is(view))
+    res = view.attr("copy")();
+  return res;
+}
+
+
 template<typename T>
 void ExportSparseMatrix(py::module m)
 {
@@ -116,12 +265,10 @@ void ExportSparseMatrix(py::module m)
     
     .def("CSR", [] (shared_ptr<SparseMatrix<T>> sp) -> py::object
          {
-           // FlatArray<int> colind(sp->NZE(), sp->GetRowIndices().Addr(0));
+           // numpy views of the CSR arrays, no copy, the arrays keep the matrix alive
+           typedef typename mat_traits<T>::TSCAL TSCAL;
            FlatArray<int> colind = sp->GetColIndices();
-           // FlatVector<T> values(sp->NZE(), sp->GetRowValues().Addr(0));
            FlatVector<T> values = sp->GetValues();
-           typedef typename mat_traits<T>::TSCAL TSCAL;
-           FlatVector<TSCAL> svalues (values.Size()*sizeof(T)/sizeof(TSCAL), (TSCAL*)(void*)values.Addr(0));
            FlatArray<size_t> first = sp->GetFirstArray();
            if (sp->NZE() != colind.Size() || sp->NZE() != values.Size())
              {
@@ -130,9 +277,14 @@ void ExportSparseMatrix(py::module m)
                     << "val.size = " << values.Size() << endl
                     << "colind.size = " << colind.Size() << endl;
              }
-           return py::make_tuple (svalues, colind, first); 
+           py::object base = py::cast(sp);
+           size_t nvals = values.Size()*sizeof(T)/sizeof(TSCAL);
+           return py::make_tuple (MakeNumPyView<TSCAL> ((TSCAL*)(void*)values.Addr(0), nvals, 1, 1, base),
+                                  MakeNumPyView<int> (colind.Addr(0), colind.Size(), 1, 1, base),
+                                  MakeNumPyView<size_t> (first.Addr(0), first.Size(), 1, 1, base));
          },
-         py::return_value_policy::reference_internal)
+         "CSR arrays (values, colind, firsti) as numpy views without copying,\n"
+         "for block entries the values are stored row-major per block")
 
     .def_property_readonly("entrysizes", [](shared_ptr<SparseMatrix<T>> self)
                            { return self->EntrySizes(); })
@@ -174,6 +326,20 @@ void ExportSparseMatrix(py::module m)
          ->shared_ptr<BaseMatrix> { return MatMult(a,b); }, py::arg("mat"))
     .def("__matmul__", [](shared_ptr<SparseMatrix<T>> a, shared_ptr<BaseMatrix> mb)
          ->shared_ptr<BaseMatrix> { return make_shared<ProductMatrix> (a, mb); }, py::arg("mat"))
+    .def("MatMultSymbolic", [] (const SparseMatrix<double> & a, const SparseMatrix<double> & b)
+         ->shared_ptr<BaseMatrix> { return MatMultSymbolic(a,b); }, py::arg("mat"),
+         "Return sparse matrix with the graph of the product self*mat, values are zero")
+    .def("MatMultSymbolic", [] (const SparseMatrix<std::complex<double>> & a, const SparseMatrix<std::complex<double>> & b)
+         ->shared_ptr<BaseMatrix> { return MatMultSymbolic(a,b); }, py::arg("mat"),
+         "Return sparse matrix with the graph of the product self*mat, values are zero")
+    .def("MatMultNumeric", [] (const SparseMatrix<double> & a, const SparseMatrix<double> & b,
+                               SparseMatrix<double> & prod)
+         { MatMultNumeric(a,b,prod); }, py::arg("mat"), py::arg("prod"),
+         "Compute values of self*mat into prod, the graph of prod is taken from MatMultSymbolic")
+    .def("MatMultNumeric", [] (const SparseMatrix<std::complex<double>> & a, const SparseMatrix<std::complex<double>> & b,
+                               SparseMatrix<std::complex<double>> & prod)
+         { MatMultNumeric(a,b,prod); }, py::arg("mat"), py::arg("prod"),
+         "Compute values of self*mat into prod, the graph of prod is taken from MatMultSymbolic")
     ;
 
   py::class_<SparseMatrixSymmetric<T>, shared_ptr<SparseMatrixSymmetric<T>>, SparseMatrix<T>>
@@ -577,7 +743,20 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                                     return py::cast(self.FVDouble());
                                   else
                                     return py::cast(self.FVComplex());
-                                })
+                                }, py::keep_alive<0,1>())
+    .def("NumPy", &VectorNumPy,
+         "numpy view of the vector (local part for parallel vectors) without copying,\n"
+         "of shape (size,) or (size, entrysize). The view keeps the vector alive.")
+    .def("__array__", [] (shared_ptr<BaseVector> self, py::object dtype, py::object copy)
+         { return ArrayProtocol (VectorNumPy(self), dtype, copy); },
+         py::arg("dtype")=py::none(), py::arg("copy")=py::none())
+    .def("__dlpack__", [] (shared_ptr<BaseVector> self, py::kwargs kw)
+         { return VectorNumPy(self).attr("__dlpack__")(**kw); })
+    .def("__dlpack_device__", [] (shared_ptr<BaseVector> self)
+         { return VectorNumPy(self).attr("__dlpack_device__")(); })
+    .def_static("FromNumPy", &VectorFromNumPy, py::arg("array"),
+                "vector referencing the memory of a C-contiguous 1D float64 or complex128 array,\n"
+                "no copy is made. The vector keeps the array alive.")
     .def("Reshape", [] (BaseVector & self, size_t w)
          {
            size_t h = self.Size()/w;
@@ -657,8 +836,27 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
   py::class_<MultiVector, MultiVectorExpr, shared_ptr<MultiVector>> (m, "MultiVector")
     .def(py::init<>([] (shared_ptr<BaseVector> bv, size_t cnt) {
           return bv->CreateMultiVector(cnt); } ))
-    .def(py::init<size_t,size_t,bool>())
+    .def(py::init([] (size_t size, size_t cnt, bool is_complex, bool contiguous) -> shared_ptr<MultiVector>
+                  {
+                    if (contiguous)
+                      return CreateContiguousMultiVector (size, cnt, is_complex);
+                    return make_shared<MultiVector> (size, cnt, is_complex);
+                  }), py::arg("size"), py::arg("cnt"), py::arg("complex"), py::arg("contiguous")=false,
+         "contiguous: all vectors in one block of memory, allows for MultiVector.NumPy()")
     .def("__len__", &MultiVector::Size)
+    .def("NumPy", [] (shared_ptr<MultiVector> self) { return MultiVectorNumPy(*self); },
+         "numpy view of shape (len, size) without copying, one row per vector.\n"
+         "Requires vectors equally spaced in memory (contiguous or FromNumPy MultiVectors)")
+    .def("__array__", [] (shared_ptr<MultiVector> self, py::object dtype, py::object copy)
+         { return ArrayProtocol (MultiVectorNumPy(*self), dtype, copy); },
+         py::arg("dtype")=py::none(), py::arg("copy")=py::none())
+    .def("__dlpack__", [] (shared_ptr<MultiVector> self, py::kwargs kw)
+         { return MultiVectorNumPy(*self).attr("__dlpack__")(**kw); })
+    .def("__dlpack_device__", [] (shared_ptr<MultiVector> self)
+         { return MultiVectorNumPy(*self).attr("__dlpack_device__")(); })
+    .def_static("FromNumPy", &MultiVectorFromNumPy, py::arg("array"),
+                "MultiVector referencing the rows of a C-contiguous 2D float64 or complex128 array,\n"
+                "no copy is made. The vectors keep the array alive.")
     .def("__getitem__",
          [](MultiVector & self, int ind )
          {
@@ -1540,6 +1738,50 @@ inverse : string
     .def("SetAbsolutePrecision", &KrylovSpaceSolver::SetAbsolutePrecision)
     ;
 
+  m.def("BlockCG", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                      shared_ptr<MultiVector> rhs, shared_ptr<MultiVector> sol,
+                      double tol, int maxsteps, bool initialize, bool printrates)
+        {
+          py::gil_scoped_release release;
+          return BlockCG (*mat, *pre, *rhs, *sol, tol, maxsteps, initialize, printrates);
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("rhs"), py::arg("sol"),
+        py::arg("tol")=1e-12, py::arg("maxsteps")=200, py::arg("initialize")=true,
+        py::arg("printrates")=false,
+        docu_string(R"raw_string(
+Block preconditioned CG for many right hand sides with the same
+symmetric positive definite matrix. Matrix and preconditioner are
+applied to the whole MultiVector at once, linearly dependent search
+directions are dropped. Returns the number of iterations.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix 
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+rhs : ngsolve.la.MultiVector
+  right hand sides
+
+sol : ngsolve.la.MultiVector
+  solution vectors, same number of vectors as rhs
+
+tol : float
+  relative reduction of the preconditioned residual of each right hand side
+
+maxsteps : int
+  maximal number of iterations
+
+initialize : bool
+  start with sol = 0, otherwise sol is the initial guess
+
+printrates : bool
+  print the norm of the residual block
+
+)raw_string"));
+  
   m.def("CGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
                        bool iscomplex, bool printrates,
                        double precision, int maxsteps, bool conjugate, optional<int> maxiter)
@@ -1772,6 +2014,60 @@ vecs : list
 shift : object
   complex or real shift
 )raw_string"));
+
+  m.def("KrylovSchur", [](shared_ptr<BaseMatrix> matm, shared_ptr<BaseMatrix> shiftinv,
+                          double shift, shared_ptr<MultiVector> start, int nev,
+                          double tol, int maxrestarts, int ncv, bool printrates)
+        {
+          shared_ptr<MultiVector> evecs = start->RefVec()->CreateMultiVector(nev);
+          Vector<double> lam;
+          {
+            py::gil_scoped_release release;
+            lam = KrylovSchur (*matm, *shiftinv, shift, *start, *evecs, nev,
+                               tol, maxrestarts, ncv, printrates);
+          }
+          return py::make_tuple (lam, evecs);
+        },
+        py::arg("matm"), py::arg("shiftinv"), py::arg("shift"), py::arg("start"), py::arg("nev"),
+        py::arg("tol")=1e-10, py::arg("maxrestarts")=100, py::arg("ncv")=0,
+        py::arg("printrates")=false,
+        docu_string(R"raw_string(
+Block Krylov-Schur eigenvalue solver for symmetric generalized EVPs
+
+Solves A*u = lam*M*u with the shift-and-invert operator (A-shift*M)^(-1)*M
+in the M-inner product. Works on blocks of vectors, the Krylov space is
+restarted with the best Ritz vectors. Returns the nev eigenvalues closest to
+the shift in ascending order, and a MultiVector with the eigenvectors.
+
+Parameters:
+
+matm : ngsolve.la.BaseMatrix
+  matrix M
+
+shiftinv : ngsolve.la.BaseMatrix
+  inverse of A-shift*M, any BaseMatrix (direct or iterative solver)
+
+shift : float
+  the shift
+
+start : ngsolve.la.MultiVector
+  start block, its size is the block size
+
+nev : int
+  number of eigenvalues
+
+tol : float
+  relative residual of the Ritz pairs of the shift-inverted problem
+
+maxrestarts : int
+  maximal number of restarts
+
+ncv : int
+  maximal dimension of the Krylov space, default max(2*nev, nev+2*blocksize)
+
+printrates : bool
+  print the number of converged eigenvalues after each restart
+)raw_string"));
   
   
 
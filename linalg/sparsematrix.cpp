@@ -62,14 +62,15 @@ namespace ngla
       colnr[i] = -1;
     */
     
+    CalcBalancing ();
+
+    // first touch memory by the row balancing (numa!)
     FlatArray<int> hcolnr = colnr;
-    ParallelForRange (nze,
-		      [hcolnr] (auto myrange)
+    ParallelForRange (balance,
+		      [hcolnr, this] (IntRange r)
 		      {
-			hcolnr.Range(myrange) = -1;
+			hcolnr.Range(firsti[r.First()], firsti[r.Next()]) = -1;
 		      });
-
-    CalcBalancing ();
   }
                                                                                                                                                                                                                   
   MatrixGraph :: MatrixGraph (int as, int max_elsperrow) 
@@ -83,14 +84,17 @@ namespace ngla
     firsti.SetSize (as+1);
     owner = true;
     
-    for (int i = 0; i < as*max_elsperrow; i++)
-      colnr[i] = -1;
-    colnr[as*max_elsperrow] = 0;
-    
     for (int i = 0; i < as+1; i++)
       firsti[i] = i*max_elsperrow;
 
     CalcBalancing ();
+
+    // first touch memory by the row balancing (numa!)
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        colnr.Range(firsti[r.First()], firsti[r.Next()]) = -1;
+                      });
+    colnr[as*max_elsperrow] = 0;
   }
   
 
@@ -116,11 +120,17 @@ namespace ngla
         
 	for (int i = 0; i < size+1; i++)
 	  firsti[i] = graph.firsti[i];
-	for (size_t i = 0; i < nze; i++)
-	  colnr[i] = graph.colnr[i];
       }
     // inversetype = agraph.GetInverseType();
     CalcBalancing ();
+
+    if (!stealgraph)
+      // copy by the row balancing, first touch (numa!)
+      ParallelForRange (balance, [&] (IntRange r)
+                        {
+                          size_t first = firsti[r.First()], next = firsti[r.Next()];
+                          colnr.Range(first, next) = graph.colnr.Range(first, next);
+                        });
   }
 
   MatrixGraph :: MatrixGraph (MatrixGraph && graph)
@@ -1397,15 +1407,15 @@ namespace ngla
   }
 
 
+  // graph of the product mata*matb, values are zero
   template <typename TM_Res, typename TM1, typename TM2>
   shared_ptr<SparseMatrixTM<TM_Res>>
-  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  MatMultSymbolic (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
   {
-    static Timer t ("sparse matrix multiplication");
+    static Timer t ("sparse matrix multiplication - symbolic");
     static Timer t1a ("sparse matrix multiplication - setup a");
     static Timer t1b ("sparse matrix multiplication - setup b");
     static Timer t1b1 ("sparse matrix multiplication - setup b1");
-    static Timer t2 ("sparse matrix multiplication - mult"); 
     RegionTimer reg(t);
 
     t1a.Start();
@@ -1487,7 +1497,28 @@ namespace ngla
 
 
     t1b.Stop();
-    t2.Start();
+    return prod;
+  }
+
+
+  /*
+    values of prod = mata*matb, the graph of prod is given.
+    The values are written to vals, stored in the order of prod's entries.
+    If lower_only, only entries (i,j) with j <= i are computed.
+    Returns false if the graph of prod misses an entry of the product.
+   */
+  template <typename TM_Res, typename TM1, typename TM2>
+  bool MatMultNumericVals (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb,
+                           const SparseMatrixTM<TM_Res> & prod, FlatVector<TM_Res> vals,
+                           bool lower_only = false)
+  {
+    static Timer t2 ("sparse matrix multiplication - mult"); 
+    RegionTimer reg(t2);
+
+    if (prod.Height() != mata.Height())
+      throw Exception ("MatMultNumeric: height of product does not match");
+    
+    atomic<bool> complete(true);
     
     ParallelForRange
       (mata.Height(), [&] (IntRange r)
@@ -1496,11 +1527,12 @@ namespace ngla
 
          size_t maxci = 0;
          for (auto i : r)
-           maxci = max2(maxci, size_t (prod->GetRowIndices(i).Size()));
+           maxci = max2(maxci, size_t (prod.GetRowIndices(i).Size()));
 
          size_t nhash = 2048;
          while (nhash < 2*maxci) nhash *= 2;
          ArrayMem<thash,2048> hash(nhash);
+         for (auto & h : hash) h.idx = -1;
          size_t nhashm1 = nhash-1;
 
          /*
@@ -1513,8 +1545,9 @@ namespace ngla
          for (auto i : r)
            {
              auto mata_ci = mata.GetRowIndices(i);
-             auto matc_ci = prod->GetRowIndices(i);
-             auto matc_vals = prod->GetRowValues(i);
+             auto matc_ci = prod.GetRowIndices(i);
+             auto matc_vals = vals.Range(prod.First(i), prod.First(i+1));
+             matc_vals = TM_Res(0.0);
              
              for (int k = 0; k < matc_ci.Size(); k++)
                {
@@ -1533,6 +1566,8 @@ namespace ngla
                  for (int k = 0; k < matb_ci.Size(); k++)
                    {
                      auto colb = matb_ci[k];
+                     if (lower_only && colb > i) continue;
+                     
                      unsigned hashval = unsigned(colb) & nhashm1; // % nhash;
                      if (hash[hashval].idx == colb)
                        { // lucky fast branch
@@ -1540,15 +1575,44 @@ namespace ngla
                        }
                      else
                       { // do the binary search
-                        (*prod)(i,colb) += vala * matb_vals[k];
+                        size_t pos = prod.GetPositionTest(i,colb);
+                        if (pos == numeric_limits<size_t>::max())
+                          complete = false;
+                        else
+                          vals(pos) += vala * matb_vals[k];
                       }
                    }
                }
+
+             // a given graph may miss entries, don't find them via stale hash entries
+             for (int k = 0; k < matc_ci.Size(); k++)
+               hash[size_t(matc_ci[k]) & nhashm1].idx = -1;
            }
        },
        TasksPerThread(10));
 
-    t2.Stop();
+    return complete;
+  }
+
+  // values of prod = mata*matb, computed in place
+  template <typename TM_Res, typename TM1, typename TM2>
+  bool MatMultNumericTM (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb,
+                         SparseMatrixTM<TM_Res> & prod, bool lower_only = false)
+  {
+    return MatMultNumericVals<TM_Res,TM1,TM2> (mata, matb, prod,
+                                               prod.AsVector().template FV<TM_Res>(), lower_only);
+  }
+
+  
+  template <typename TM_Res, typename TM1, typename TM2>
+  shared_ptr<SparseMatrixTM<TM_Res>>
+  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  {
+    static Timer t ("sparse matrix multiplication");
+    RegionTimer reg(t);
+
+    auto prod = MatMultSymbolic<TM_Res,TM1,TM2> (mata, matb);
+    MatMultNumericTM<TM_Res,TM1,TM2> (mata, matb, *prod);
     return prod;
   }
 
@@ -1563,10 +1627,35 @@ namespace ngla
     return MatMult<std::complex<double>, std::complex<double>, std::complex<double>>(mata, matb);
   }
 
+  shared_ptr<SparseMatrixTM<double>> MatMultSymbolic (const SparseMatrixTM<double> & mata,
+                                                      const SparseMatrixTM<double> & matb)
+  {
+    return MatMultSymbolic<double, double, double>(mata, matb);
+  }
+  shared_ptr<SparseMatrixTM<std::complex<double>>> MatMultSymbolic (const SparseMatrixTM<std::complex<double>> & mata,
+                                                                    const SparseMatrixTM<std::complex<double>> & matb)
+  {
+    return MatMultSymbolic<std::complex<double>, std::complex<double>, std::complex<double>>(mata, matb);
+  }
+
+  void MatMultNumeric (const SparseMatrixTM<double> & mata, const SparseMatrixTM<double> & matb,
+                       SparseMatrixTM<double> & prod)
+  {
+    if (!MatMultNumericTM<double, double, double>(mata, matb, prod))
+      throw Exception ("MatMultNumeric: graph of product matrix does not fit");
+  }
+  void MatMultNumeric (const SparseMatrixTM<std::complex<double>> & mata,
+                       const SparseMatrixTM<std::complex<double>> & matb,
+                       SparseMatrixTM<std::complex<double>> & prod)
+  {
+    if (!MatMultNumericTM<std::complex<double>, std::complex<double>, std::complex<double>>(mata, matb, prod))
+      throw Exception ("MatMultNumeric: graph of product matrix does not fit");
+  }
+
   template <class TM, class TV>
   shared_ptr<BaseSparseMatrix>
   SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
-					    shared_ptr<BaseSparseMatrix> acmat ) const
+					    shared_ptr<BaseSparseMatrix> acmat, bool inplace) const
   {
     static Timer t ("sparsematrix - restrict");
     static Timer tbuild ("sparsematrix - restrict, build matrix");
@@ -1576,6 +1665,8 @@ namespace ngla
     int n = this->Height();
 
     auto cmat = dynamic_pointer_cast<SparseMatrixSymmetric<TM,TV>>(acmat);
+    if (cmat && !inplace)
+      cmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*cmat, false);
  
     // if no coarse matrix, build up matrix-graph!
     if ( !cmat )
@@ -1700,32 +1791,129 @@ namespace ngla
 
 
 
+  static size_t GraphHash (const MatrixGraph & graph)
+  {
+    size_t hash = graph.Size();
+    for (size_t i = 0; i < graph.Size(); i++)
+      {
+        auto ri = graph.GetRowIndices(i);
+        hash = hash * 31 + ri.Size();
+        for (int col : ri)
+          hash = hash * 31 + col;
+      }
+    return hash;
+  }
+  
+  /*
+    P^T and mat*P for Restrict. The graphs of P^T and mat*P are built once
+    and reused as long as the same prolongation object with the same graph
+    is passed, the values are recomputed in every call.
+  */
+  template <typename TM_AP, typename TM>
+  static tuple<shared_ptr<SparseMatrixTM<double>>, shared_ptr<SparseMatrixTM<TM_AP>>>
+  RestrictFactors (const SparseMatrixTM<TM> & mat, const SparseMatrixTM<double> & prol,
+                   SparseRestrictCache & cache)
+  {
+    static Timer tbuild ("sparsematrix - restrict, build factors");
+    
+    size_t hash = GraphHash (prol);
+    auto ap = dynamic_pointer_cast<SparseMatrixTM<TM_AP>> (cache.ap);
+    if (!ap || cache.prol.lock().get() != &prol || cache.prol_graph_hash != hash ||
+        ap->Height() != mat.Height() || ap->Width() != prol.Width())
+      {
+        RegionTimer reg(tbuild);
+        cache.prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
+        cache.prolT_pos.SetSize (prol.NZE());
+        ParallelFor (prol.Height(), [&] (size_t i)
+                     {
+                       auto ri = prol.GetRowIndices(i);
+                       for (size_t j = 0; j < ri.Size(); j++)
+                         cache.prolT_pos[prol.First(i)+j] = cache.prolT->GetPosition (ri[j], i);
+                     });
+        ap = MatMultSymbolic<TM_AP, TM, double> (mat, prol);
+        cache.ap = ap;
+        cache.prol_graph_hash = hash;
+        try
+          {
+            cache.prol = prol.shared_from_this();
+          }
+        catch (bad_weak_ptr &)
+          {
+            // not owned by a shared_ptr, no way to recognize it next time
+            cache.prol.reset();
+          }
+      }
+    else
+      {
+        // P may have new values
+        auto prolvals = prol.AsVector().template FV<double>();
+        auto prolTvals = cache.prolT->AsVector().template FV<double>();
+        ParallelFor (prol.NZE(), [&] (size_t k)
+                     { prolTvals(cache.prolT_pos[k]) = prolvals(k); });
+      }
+    
+    if (!MatMultNumericTM<TM_AP, TM, double> (mat, prol, *ap))
+      {
+        // the graph of mat has changed, redo the symbolic phase
+        ap = MatMultSymbolic<TM_AP, TM, double> (mat, prol);
+        cache.ap = ap;
+        MatMultNumericTM<TM_AP, TM, double> (mat, prol, *ap);
+      }
+    return { cache.prolT, ap };
+  }
+
+  /*
+    values of cmat = prolT * ap on the given graph of cmat. Nothing is
+    written if the graph misses an entry of the product.
+  */
+  template <typename TM_Res, typename TM2>
+  static bool RestrictNumeric (const SparseMatrixTM<double> & prolT, const SparseMatrixTM<TM2> & ap,
+                               SparseMatrixTM<TM_Res> & cmat, bool lower_only)
+  {
+    if (cmat.Height() != prolT.Height() || cmat.Width() != ap.Width())
+      return false;
+    Vector<TM_Res> vals(cmat.NZE());
+    if (!MatMultNumericVals<TM_Res, double, TM2> (prolT, ap, cmat, vals, lower_only))
+      return false;
+    cmat.AsVector().template FV<TM_Res>() = vals;
+    return true;
+  }
+
   template <> shared_ptr<BaseSparseMatrix>
   SparseMatrix<double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                    shared_ptr<BaseSparseMatrix> acmat ) const
+                                    shared_ptr<BaseSparseMatrix> acmat, bool inplace) const
   {
     static Timer t ("sparsematrix - restrict");
     RegionTimer reg(t);
 
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
+    auto [prolT, prod1] = RestrictFactors<double> (*this, prol, this->restrict_cache);
 
-    auto prod1 = MatMult<double, double, double>(*this, prol);
+    // reuse the graph of a given coarse matrix, only values are computed
+    auto cmat = dynamic_pointer_cast<SparseMatrixTM<double>> (acmat);
+    if (cmat && !inplace)
+      cmat = make_shared<SparseMatrix<double>> (*cmat, false);
+    if (cmat && RestrictNumeric (*prolT, *prod1, *cmat, false))
+      return cmat;
+    
     auto prod = MatMult<double, double, double>(*prolT, *prod1);
     return prod;
   }
 
   template <> shared_ptr<BaseSparseMatrix>
   SparseMatrix<std::complex<double>> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                  shared_ptr<BaseSparseMatrix> acmat ) const
+                                                  shared_ptr<BaseSparseMatrix> acmat, bool inplace) const
   {
     static Timer t ("sparsematrix - restrict");
     RegionTimer reg(t);
     // new version
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
+    auto [prolT, prod1] = RestrictFactors<std::complex<double>> (*this, prol, this->restrict_cache);
+
+    auto cmat = dynamic_pointer_cast<SparseMatrixTM<std::complex<double>>> (acmat);
+    if (cmat && !inplace)
+      cmat = make_shared<SparseMatrix<std::complex<double>>> (*cmat, false);
+    if (cmat && RestrictNumeric (*prolT, *prod1, *cmat, false))
+      return cmat;
     
-    auto prod1 = MatMult<std::complex<double>, std::complex<double>, double>(*this, prol);
     auto prod = MatMult<std::complex<double>, double, std::complex<double>>(*prolT, *prod1);
     return prod;
   }
@@ -1736,16 +1924,21 @@ namespace ngla
 
   template <> shared_ptr<BaseSparseMatrix>
   SparseMatrixSymmetric<double,double> :: Restrict (const SparseMatrixTM<double> & prol,
-                                                    shared_ptr<BaseSparseMatrix> acmat ) const
+                                                    shared_ptr<BaseSparseMatrix> acmat, bool inplace) const
   {
     static Timer t ("sparsematrixsymmetric - restrict");
     RegionTimer reg(t);
     // new version
-    // auto prolT = TransposeMatrix(prol);
-    auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());    
     auto full = MakeFullMatrix(*this);
-
-    auto prod1 = MatMult<double, double, double>(*full, prol);
+    auto [prolT, prod1] = RestrictFactors<double> (*full, prol, this->restrict_cache);
+
+    // reuse the graph of a given coarse matrix, compute only the lower triangle
+    auto cmat = dynamic_pointer_cast<SparseMatrixSymmetric<double,double>> (acmat);
+    if (cmat && !inplace)
+      cmat = make_shared<SparseMatrixSymmetric<double,double>> (*cmat, false);
+    if (cmat && RestrictNumeric (*prolT, *prod1, *cmat, true))
+      return cmat;
+    
     auto prod = MatMult<double, double, double>(*prolT, *prod1);
 
     auto prodhalf = GetSymmetricMatrix (*prod);
@@ -253,8 +253,14 @@ namespace ngla
       throw Exception ("BaseSparseMatrix::CreateInverse called");
     }
 
+    /*
+      Galerkin projection P^T A P. The graph of a given cmat is reused, the
+      values are written into cmat only if inplace is set, otherwise into
+      a new matrix.
+    */
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
-                                                   shared_ptr<BaseSparseMatrix> cmat = nullptr ) const
+                                                   shared_ptr<BaseSparseMatrix> cmat = nullptr,
+                                                   bool inplace = false) const
     {
       throw Exception ("BaseSparseMatrix::Restrict");
     }
@@ -345,6 +351,22 @@ namespace ngla
     }
   };
 
+
+  /*
+    Kept by the fine matrix between calls of Restrict with the same
+    prolongation: the graphs of P^T and A*P. The cache is valid as long as
+    the same prolongation object with the same graph is passed, the values
+    of P^T are copied from P in every call.
+  */
+  struct SparseRestrictCache
+  {
+    weak_ptr<const BaseMatrix> prol;
+    size_t prol_graph_hash = 0;
+    shared_ptr<SparseMatrixTM<double>> prolT;
+    Array<size_t> prolT_pos;   // position in P^T of the entries of P
+    shared_ptr<BaseSparseMatrix> ap;
+  };
+
   
   /// A general, sparse matrix
   template<class TM>
@@ -356,6 +378,7 @@ namespace ngla
     NumaDistributedArray<TM> data;
     TM nul;
     bool hermitian = false;
+    mutable SparseRestrictCache restrict_cache;
     
     typedef S_BaseSparseMatrix<typename mat_traits<TM>::TSCAL> BASE;
     using BASE::firsti;
@@ -389,6 +412,9 @@ namespace ngla
       // SetEntrySize (Height<TM>(), Width<TM>(), sizeof(TM)/sizeof(TSCAL));
       SetEntrySize ();
       asvec.AssignMemory (nze*sizeof(TM)/sizeof(TSCAL), (void*)data.Addr(0));
+#ifndef USE_NUMA
+      SetZero ();   // first touch by the row balancing, NumaDistributedArray places the pages itself
+#endif
       GetMemoryTracer().Track(*static_cast<MatrixGraph*>(this), "MatrixGraph",
                               data, "data");
       GetMemoryTracer().SetName("SparseMatrix");
@@ -401,6 +427,9 @@ namespace ngla
       // SetEntrySize (mat_traits<TM>::HEIGHT, mat_traits<TM>::WIDTH, sizeof(TM)/sizeof(TSCAL));
       SetEntrySize ();      
       asvec.AssignMemory (nze*sizeof(TM)/sizeof(TSCAL), (void*)data.Addr(0));
+#ifndef USE_NUMA
+      SetZero ();   // first touch by the row balancing, NumaDistributedArray places the pages itself
+#endif
       GetMemoryTracer().Track(*static_cast<MatrixGraph*>(this), "MatrixGraph",
                               data, "data");
       GetMemoryTracer().SetName("SparseMatrix");
@@ -415,6 +444,9 @@ namespace ngla
       // SetEntrySize (mat_traits<TM>::HEIGHT, mat_traits<TM>::WIDTH, sizeof(TM)/sizeof(TSCAL));
       SetEntrySize ();            
       asvec.AssignMemory (nze*sizeof(TM)/sizeof(TSCAL), (void*)data.Addr(0));
+#ifndef USE_NUMA
+      SetZero ();   // first touch by the row balancing, NumaDistributedArray places the pages itself
+#endif
       GetMemoryTracer().Track(*static_cast<MatrixGraph*>(this), "MatrixGraph",
                               data, "data");
       GetMemoryTracer().SetName("SparseMatrix");
@@ -428,6 +460,9 @@ namespace ngla
       // SetEntrySize (mat_traits<TM>::HEIGHT, mat_traits<TM>::WIDTH, sizeof(TM)/sizeof(TSCAL));
       SetEntrySize ();      
       asvec.AssignMemory (nze*sizeof(TM)/sizeof(TSCAL), (void*)data.Addr(0));
+#ifndef USE_NUMA
+      SetZero ();   // first touch by the row balancing, NumaDistributedArray places the pages itself
+#endif
       FindSameNZE();
       GetMemoryTracer().Track(*static_cast<MatrixGraph*>(this), "MatrixGraph",
                               data, "data");
@@ -441,7 +476,12 @@ namespace ngla
       // SetEntrySize (mat_traits<TM>::HEIGHT, mat_traits<TM>::WIDTH, sizeof(TM)/sizeof(TSCAL));
       SetEntrySize ();            
       asvec.AssignMemory (nze*sizeof(TM)/sizeof(TSCAL), (void*)data.Addr(0));      
-      AsVector() = amat.AsVector();
+      // copy by the row balancing (NUMA placement)
+      ParallelForRange (balance, [&](IntRange r)
+                        {
+                          size_t first = firsti[r.First()], next = firsti[r.Next()];
+                          data.Range(first, next) = amat.data.Range(first, next);
+                        });
       GetMemoryTracer().Track(*static_cast<MatrixGraph*>(this), "MatrixGraph",
                               data, "data");
       GetMemoryTracer().SetName("SparseMatrix");
@@ -618,7 +658,8 @@ namespace ngla
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<const Array<int>> clusters) const override;
 
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
-					 shared_ptr<BaseSparseMatrix> cmat = nullptr) const override;
+					 shared_ptr<BaseSparseMatrix> cmat = nullptr,
+                                         bool inplace = false) const override;
     
     virtual shared_ptr<BaseSparseMatrix> Reorder (const Array<size_t> & reorder) const override;
     
@@ -777,9 +818,10 @@ namespace ngla
 
 
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
-					 shared_ptr<BaseSparseMatrix> cmat = nullptr) const override;
+					 shared_ptr<BaseSparseMatrix> cmat = nullptr,
+                                         bool inplace = false) const override;
 
-    ///
+    /// parallel, using the row balancing of the graph
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
 
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
@@ -787,6 +829,9 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    /// all vectors in one sweep over the matrix
+    virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
+
 
     /*
       y += s L * x
@@ -852,6 +897,23 @@ namespace ngla
   NGS_DLL_HEADER shared_ptr<SparseMatrixTM<Complex>>
   MatMult (const SparseMatrixTM<Complex> & mata, const SparseMatrixTM<Complex> & matb);
 
+  /*
+    Sparse matrix product in two phases: MatMultSymbolic creates the
+    product matrix with its graph (and zero values), MatMultNumeric
+    (re-)computes the values for a matrix with this graph. As long as the
+    graphs of the factors do not change, the symbolic phase is done once.
+  */
+  NGS_DLL_HEADER shared_ptr<SparseMatrixTM<double>>
+  MatMultSymbolic (const SparseMatrixTM<double> & mata, const SparseMatrixTM<double> & matb);
+  NGS_DLL_HEADER shared_ptr<SparseMatrixTM<Complex>>
+  MatMultSymbolic (const SparseMatrixTM<Complex> & mata, const SparseMatrixTM<Complex> & matb);
+  NGS_DLL_HEADER void
+  MatMultNumeric (const SparseMatrixTM<double> & mata, const SparseMatrixTM<double> & matb,
+                  SparseMatrixTM<double> & prod);
+  NGS_DLL_HEADER void
+  MatMultNumeric (const SparseMatrixTM<Complex> & mata, const SparseMatrixTM<Complex> & matb,
+                  SparseMatrixTM<Complex> & prod);
+
 #ifdef GOLD
 #include <sparsematrix_spec.hpp>
 #endif
@@ -155,11 +155,19 @@ namespace ngla
   MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
     static Timer t("SparseMatrix::MultAdd"); RegionTimer reg(t);
+    static Timer tpart("SparseMatrix::MultAdd - part");
     t.AddFlops (this->NZE()*sizeof(TV_ROW)*sizeof(TV_COL)/sqr(sizeof(double)));
 
     ParallelForRange
       (balance, [&] (IntRange myrange)
        {
+         TraceRegion tr(tpart);
+         if (tr.Active())
+           {
+             size_t nze = this->firsti[myrange.Next()] - this->firsti[myrange.First()];
+             tr.AddFlops (nze*sizeof(TV_ROW)*sizeof(TV_COL)/sqr(sizeof(double)));
+             tr.AddBytes (nze*(sizeof(TM)+sizeof(int)));
+           }
          FlatVector<TVX> fx = x.FV<TVX>(); 
          FlatVector<TVY> fy = y.FV<TVY>(); 
 
@@ -485,6 +493,17 @@ namespace ngla
     Array<MemoryUsage> mu;
     mu += { "SparseMatrix", nze*sizeof(TM), 1 };
     if (owner) mu += MatrixGraph::GetMemoryUsage ();
+
+    // P^T and A*P kept for Restrict
+    size_t nbytes_restrict = restrict_cache.prolT_pos.Size()*sizeof(size_t);
+    if (restrict_cache.prolT)
+      for (auto & m : restrict_cache.prolT->GetMemoryUsage())
+        nbytes_restrict += m.NBytes();
+    if (restrict_cache.ap)
+      for (auto & m : restrict_cache.ap->GetMemoryUsage())
+        nbytes_restrict += m.NBytes();
+    if (nbytes_restrict)
+      mu += { "SparseMatrix, restrict cache", nbytes_restrict, 1 };
     return mu;
   }
 
@@ -511,7 +530,7 @@ namespace ngla
   CreateVector () const
   {
     if (this->size==this->width)
-      return make_unique<VVector<TVY>> (this->size);
+      return make_unique<VVector<TVY>> (this->size, this->balance);
     throw Exception ("SparseMatrix::CreateVector for rectangular does not make sense, use either CreateColVector or CreateRowVector");
   }
 
@@ -519,21 +538,21 @@ namespace ngla
   AutoVector SparseMatrix<TM,TV_ROW,TV_COL> ::
   CreateRowVector () const
   {
-    return make_unique<VVector<TVX>> (this->width);
+    return make_unique<VVector<TVX>> (this->width, this->balance);
   }
 
   template <class TM, class TV_ROW, class TV_COL>
   AutoVector SparseMatrix<TM,TV_ROW,TV_COL> ::
   CreateColVector () const
   {
-    return make_unique<VVector<TVY>> (this->size);
+    return make_unique<VVector<TVY>> (this->size, this->balance);
   }
 
 
   template<class TM, class TV_ROW, class TV_COL>
   shared_ptr<BaseSparseMatrix>
   SparseMatrix<TM,TV_ROW,TV_COL> :: Restrict (const SparseMatrixTM<double> & prol,
-                                  shared_ptr<BaseSparseMatrix> acmat ) const
+                                  shared_ptr<BaseSparseMatrix> acmat, bool inplace) const
   {
     static Timer t ("sparsematrix - restrict");
     static Timer tbuild ("sparsematrix - restrict, build matrix");
@@ -543,6 +562,8 @@ namespace ngla
     int n = this->Height();
 
     auto cmat = dynamic_pointer_cast<SparseMatrixTM<TM>> (acmat);
+    if (cmat && !inplace)
+      cmat = make_shared<SparseMatrix<TM,TV_ROW,TV_COL>> (*cmat, false);
  
     // if no coarse matrix, build up matrix-graph!
     if ( !cmat )
@@ -832,6 +853,110 @@ namespace ngla
     ; 
   }
 
+  /*
+    Parallel product with the lower-triangular storage, for M vectors
+    (M = 0 .. number of vectors known at run-time only):
+
+      y_k += alpha_k * ( [L] + [D] + [L^T] ) x_k
+
+    restricted to rows i with use_row(i). The rows are processed in the
+    blocks of the row balancing. The row part and the transposed entries
+    with target inside the own block are conflict-free, they are added
+    in the first phase. Transposed entries with target in an earlier
+    block are added with atomics in the second phase.
+  */
+  template <int M, class TM, class TV, typename TFILTER>
+  static void SymmetricMultAdd (const SparseMatrixSymmetric<TM,TV> & mat,
+                                FlatVector<double> alpha,
+                                FlatArray<TV*> px, FlatArray<TV*> py,
+                                bool lower, bool diag, bool upper,
+                                TFILTER use_row)
+  {
+    typedef typename mat_traits<TV>::TSCAL TSCALV;
+    size_t m = (M > 0) ? M : px.Size();
+    auto & balance = mat.GetBalancing();
+    size_t h = mat.Height();
+    size_t nblocks = max(balance.Size(), size_t(1));
+    auto Block = [&] (size_t b)
+      { return balance.Size() ? IntRange(balance[b]) : IntRange(0, h); };
+    auto firsti = mat.GetFirstArray();
+    auto colnr = mat.GetColIndices();
+    auto data = mat.GetValues();
+
+    ParallelFor (nblocks, [&] (size_t b)
+      {
+        IntRange r = Block(b);
+        size_t blockstart = r.First();
+        ArrayMem<TV,4> sum(m), sxi(m);
+        for (size_t i : r)
+          {
+            if (!use_row(i)) continue;
+            size_t first = firsti[i], last = firsti[i+1];
+            bool hasdiag = last > first && colnr[last-1] == i;
+            if (hasdiag) last--;
+
+            for (size_t k = 0; k < m; k++)
+              {
+                sum[k] = TSCALV(0);
+                sxi[k] = alpha(k) * px[k][i];
+              }
+            if (diag && hasdiag)
+              for (size_t k = 0; k < m; k++)
+                {
+                  if (lower)
+                    sum[k] += data[last] * px[k][i];
+                  else
+                    sum[k] += Trans(data[last]) * px[k][i];
+                }
+
+            for (size_t j = first; j < last; j++)
+              {
+                size_t c = colnr[j];
+                if (lower)
+                  for (size_t k = 0; k < m; k++)
+                    sum[k] += data[j] * px[k][c];
+                if (upper && c >= blockstart)
+                  for (size_t k = 0; k < m; k++)
+                    py[k][c] += Trans(data[j]) * sxi[k];
+              }
+            for (size_t k = 0; k < m; k++)
+              py[k][i] += alpha(k) * sum[k];
+          }
+      });
+
+    if (upper && nblocks > 1)
+      ParallelFor (nblocks, [&] (size_t b)
+        {
+          IntRange r = Block(b);
+          size_t blockstart = r.First();
+          ArrayMem<TV,4> sxi(m);
+          for (size_t i : r)
+            {
+              if (!use_row(i)) continue;
+              for (size_t k = 0; k < m; k++)
+                sxi[k] = alpha(k) * px[k][i];
+              // columns are sorted, entries to other blocks come first
+              for (size_t j = firsti[i]; j < firsti[i+1] && size_t(colnr[j]) < blockstart; j++)
+                for (size_t k = 0; k < m; k++)
+                  AtomicAdd (py[k][colnr[j]], TV(Trans(data[j]) * sxi[k]));
+            }
+        });
+  }
+
+  template <int M, class TM, class TV, typename TFILTER>
+  static void SymmetricMultAdd (const SparseMatrixSymmetric<TM,TV> & mat, double s,
+                                const BaseVector & x, BaseVector & y,
+                                bool lower, bool diag, bool upper,
+                                TFILTER use_row)
+  {
+    TV * px = x.FV<TV>().Data();
+    TV * py = y.FV<TV>().Data();
+    SymmetricMultAdd<1> (mat, FlatVector<double>(1, &s),
+                         FlatArray<TV*>(1, &px), FlatArray<TV*>(1, &py),
+                         lower, diag, upper, use_row);
+  }
+
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd (double s, const BaseVector & x, BaseVector & y) const
@@ -840,14 +965,33 @@ namespace ngla
     RegionTimer reg (timer);
     timer.AddFlops (2*this->nze);
 
-    const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
-    FlatVector<TV_COL> fy = y.FV<TV_COL>();
+    SymmetricMultAdd<1> (*this, s, x, y, true, true, true,
+                         [] (size_t i) { return true; });
+  }
 
-    for (int i = 0; i < this->Height(); i++)
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
+  {
+    if (x.Size() == 0) return;
+    if (x.IsComplex() != ngbla::IsComplex<TV>() || y.IsComplex() != ngbla::IsComplex<TV>())
+      {
+        BaseMatrix::MultAdd (alpha, x, y);
+        return;
+      }
+    
+    static Timer timer("SparseMatrixSymmetric::MultAdd MultiVector");
+    RegionTimer reg (timer);
+    timer.AddFlops (2*this->nze*x.Size());
+
+    Array<TV*> px(x.Size()), py(y.Size());
+    for (size_t k = 0; k < x.Size(); k++)
       {
-	fy(i) += s * RowTimesVector (i, fx);
-	AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+        px[k] = x[k]->FV<TV>().Data();
+        py[k] = y[k]->FV<TV>().Data();
       }
+    SymmetricMultAdd<0> (*this, alpha, px, py, true, true, true,
+                         [] (size_t i) { return true; });
   }
 
   template <class TM, class TV>
@@ -856,35 +1000,26 @@ namespace ngla
 	    const BitArray * inner,
 	    const Array<int> * cluster) const
   {
-    const FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
-    FlatVector<TV_COL> fy = y.FV<TV_COL> ();
-    
     if (inner)
       {
 	static Timer timer("SparseMatrixSymmetric::MultAdd1 - inner");
 	RegionTimer reg (timer);
-
-	for (int i = 0; i < this->Height(); i++)
-	  if (inner->Test(i))
-	    fy(i) += s * RowTimesVectorNoDiag (i, fx);
+        SymmetricMultAdd<1> (*this, s, x, y, true, false, false,
+                             [inner] (size_t i) { return inner->Test(i); });
       }
     else if (cluster)
       {
 	static Timer timer("SparseMatrixSymmetric::MultAdd1 - cluster");
 	RegionTimer reg (timer);
-
-	for (int i = 0; i < this->Height(); i++)
-	  if ( (*cluster)[i])
-	    fy(i) += s * RowTimesVectorNoDiag (i, fx);
+        SymmetricMultAdd<1> (*this, s, x, y, true, false, false,
+                             [cluster] (size_t i) { return (*cluster)[i] != 0; });
       }
     else
       {
 	static Timer timer("SparseMatrixSymmetric::MultAdd1");
 	RegionTimer reg (timer);
-	
-
-	for (int i = 0; i < this->Height(); i++)
-	  fy(i) += s * RowTimesVectorNoDiag (i, fx);
+        SymmetricMultAdd<1> (*this, s, x, y, true, false, false,
+                             [] (size_t i) { return true; });
       }
   }
   
@@ -899,24 +1034,15 @@ namespace ngla
     RegionTimer reg (timer);
     timer.AddFlops (this->NZE());
    
-    const FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
-    FlatVector<TV_COL> fy = y.FV<TV_COL> ();
-
     if (inner)
-      {
-	for (int i = 0; i < this->Height(); i++)
-	  if (inner->Test(i))
-	    AddRowTransToVector (i, s * fx(i), fy);
-      }
+      SymmetricMultAdd<1> (*this, s, x, y, false, true, true,
+                           [inner] (size_t i) { return inner->Test(i); });
     else if (cluster)
-      {
-	for (int i = 0; i < this->Height(); i++)
-	  if ( (*cluster)[i])
-	    AddRowTransToVector (i, s * fx(i), fy);
-      }
+      SymmetricMultAdd<1> (*this, s, x, y, false, true, true,
+                           [cluster] (size_t i) { return (*cluster)[i] != 0; });
     else
-      for (int i = 0; i < this->Height(); i++)
-	AddRowTransToVector (i, s * fx(i), fy);
+      SymmetricMultAdd<1> (*this, s, x, y, false, true, true,
+                           [] (size_t i) { return true; });
   }
 
 
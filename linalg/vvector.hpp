@@ -5,6 +5,15 @@ namespace ngla
   template <class T> class VFlatVector;
   template <class T> class VVector;
 
+  /**
+     Placement of vector memory on NUMA nodes.
+     false (default): first touch in parallel by the threads of the row
+     partition which later use it.
+     true: interleaved over all nodes, set by the environment variable
+     NGS_NUMA_INTERLEAVE=1 or ngsglobals.numa_interleave
+  */
+  NGS_DLL_HEADER extern bool numa_interleave;
+
 
 
 
@@ -15,6 +24,12 @@ namespace ngla
     TSCAL * pdata;
     int es;
     bool ownmem;
+    // memory if allocated interleaved
+    shared_ptr<NumaInterleavedArray<TSCAL>> numa_mem;
+
+    /// allocates n scalars, first touched by the partition (rows of es scalars) or interleaved
+    void AllocateMemory (size_t n, const Partitioning * part = nullptr);
+    void FreeMemory ();
     
   public:
     S_BaseVectorPtr (size_t as, int aes, void * adata) throw()
@@ -30,7 +45,18 @@ namespace ngla
     {
       this->size = as;
       es = aes;
-      pdata = new TSCAL[as*aes];
+      AllocateMemory (as*aes);
+      ownmem = true;
+      GetMemoryTracer().Alloc(sizeof(TSCAL) * as * aes);
+      this->entrysize = es * sizeof(TSCAL) / sizeof(double);
+    }
+
+    /// memory placed on the NUMA nodes of the threads working on the rows of part (e.g. a matrix balancing)
+    S_BaseVectorPtr (size_t as, int aes, const Partitioning & part)
+    {
+      this->size = as;
+      es = aes;
+      AllocateMemory (as*aes, &part);
       ownmem = true;
       GetMemoryTracer().Alloc(sizeof(TSCAL) * as * aes);
       this->entrysize = es * sizeof(TSCAL) / sizeof(double);
@@ -41,10 +67,10 @@ namespace ngla
       if (ownmem)
         {
           GetMemoryTracer().Free(sizeof(TSCAL) * this->size * es);
-          delete [] pdata;
+          FreeMemory();
         }
       this->size = as;
-      pdata = new TSCAL[as*es];
+      AllocateMemory (as*es);
       ownmem = true;
       GetMemoryTracer().Alloc(sizeof(TSCAL) * as * es);
     }
@@ -154,6 +180,10 @@ namespace ngla
       : S_BaseVectorPtr<TSCAL> (as, ES) 
     { ; }
 
+    VVector (size_t as, const Partitioning & part)
+      : S_BaseVectorPtr<TSCAL> (as, ES, part)
+    { ; }
+
     explicit VVector (const VVector & v2)
       : S_BaseVectorPtr<TSCAL> (v2.Size(), ES)
     {
@@ -98,6 +98,18 @@ namespace ngmg
     if (prolongation)
       prolongation->Update(*biform->GetFESpace());
 
+    // build transfer matrices and coarse vectors now, Mult only reads them
+    if (prolongation && smoother && use_prolongation_matrix)
+      {
+        coarse_d.SetSize (ma->GetNLevels());
+        coarse_w.SetSize (ma->GetNLevels());
+        for (int level = 1; level < ma->GetNLevels(); level++)
+          {
+            prolongation->GetRestrictionMatrix(level);
+            coarse_d[level-1] = smoother->CreateVector(level-1);
+            coarse_w[level-1] = smoother->CreateVector(level-1);
+          }
+      }
 
     //  coarsegridpre = biform.GetMatrix(1).CreateJacobiPrecond();
     // InverseMatrix();
@@ -262,16 +274,46 @@ namespace ngmg
                   smoother->Residuum (level, u, f, *d);
                 }
             
-	    prolongation->RestrictInline (level, d);
-	    w = 0;
-      if (level == 1) 
-        MGM (level-1, wt, dt, incsm * incsmooth);
-      else{
-        for (int j = 1; j <= cycle; j++)
-          MGM (level-1, wt, dt, incsm * incsmooth);
-      }
-
-	    prolongation->ProlongateInline (level, w);
+            shared_ptr<SparseMatrix<double>> prolmat, restmat;
+            if (use_prolongation_matrix && !IsComplex() && u.EntrySize() == 1 &&
+                level-1 < coarse_d.Size() && coarse_d[level-1])
+              {
+                prolmat = prolongation->GetProlongationMatrix (level);
+                restmat = prolongation->GetRestrictionMatrix (level);
+              }
+
+            if (prolmat && restmat)
+              {
+                // SpMV-based transfer, coarse vectors are separate to avoid aliasing
+                auto & dc = *coarse_d[level-1];
+                auto & wc = *coarse_w[level-1];
+                dc = 0.0;
+                wc = 0.0;
+                auto dfine = d.Range(0, restmat->Width());
+                auto dcoarse = dc.Range(0, restmat->Height());
+                restmat->Mult (dfine, dcoarse);
+
+                for (int j = 1; j <= (level == 1 ? 1 : cycle); j++)
+                  MGM (level-1, wc, dc, incsm * incsmooth);
+
+                w = 0.0;
+                auto wcoarse = wc.Range(0, prolmat->Width());
+                auto wfine = w.Range(0, prolmat->Height());
+                prolmat->Mult (wcoarse, wfine);
+              }
+            else
+              {
+                prolongation->RestrictInline (level, d);
+                w = 0;
+                if (level == 1) 
+                  MGM (level-1, wt, dt, incsm * incsmooth);
+                else{
+                  for (int j = 1; j <= cycle; j++)
+                    MGM (level-1, wt, dt, incsm * incsmooth);
+                }
+                
+                prolongation->ProlongateInline (level, w);
+              }
 	    u += w;
 
             if (harmonic_extension_prolongation)            
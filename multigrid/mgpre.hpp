@@ -51,6 +51,10 @@ namespace ngmg
     /// for robust prolongation
     bool harmonic_extension_prolongation = false;
     Array<shared_ptr<BaseMatrix>> he_prolongation;
+    /// grid transfer by cached sparse matrices
+    bool use_prolongation_matrix = false;
+    /// coarse defect and correction of the matrix based transfer, per level
+    Array<shared_ptr<BaseVector>> coarse_d, coarse_w;
   public:
     ///
     MultigridPreconditioner (shared_ptr<BilinearForm> abiform,
@@ -81,6 +85,9 @@ namespace ngmg
     ///
     void SetHarmonicExtensionProlongation (bool he = true)
     { harmonic_extension_prolongation = he; }
+    ///
+    void SetUseProlongationMatrix (bool upm = true)
+    { use_prolongation_matrix = upm; }
     
     ///
     virtual void Update () override;
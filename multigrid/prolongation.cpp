@@ -25,8 +25,65 @@ namespace ngmg
 
   void Prolongation :: Update (const FESpace & fes)
   {
-    if (leveldofs.Size() < fes.GetMeshAccess()->GetNLevels())
-      leveldofs.Append (DofRange(fes.GetNDof(), fes.GetParallelDofs()));
+    size_t nlevels = fes.GetMeshAccess()->GetNLevels();
+    size_t ndof = fes.GetNDof();
+
+    // levels which are gone (mesh reset), and the finest level if its
+    // number of dofs has changed (e.g. new order), are recorded anew.
+    // Transfer matrices into these levels are outdated.
+    size_t valid = min2(leveldofs.Size(), nlevels);
+    if (valid == nlevels && valid > 0 && leveldofs[valid-1].Size() != ndof)
+      valid--;
+    for (size_t level = valid; level < prolmats.Size(); level++)
+      {
+        prolmats[level] = nullptr;
+        restmats[level] = nullptr;
+      }
+    leveldofs.SetSize (valid);
+    
+    if (leveldofs.Size() < nlevels)
+      leveldofs.Append (DofRange(ndof, fes.GetParallelDofs()));
+  }
+
+  
+  shared_ptr<SparseMatrix< double >> Prolongation :: GetProlongationMatrix (int finelevel) const
+  {
+    if (finelevel < 1)
+      throw Exception("Illegal level " + ToString(finelevel) + " for prolongation matrix");
+
+    if (prolmats.Size() <= finelevel)
+      {
+        prolmats.SetSize (finelevel+1);
+        restmats.SetSize (finelevel+1);
+      }
+    
+    if (!prolmats[finelevel])
+      {
+        static Timer t("Prolongation::CreateMatrix"); RegionTimer r(t);
+        prolmats[finelevel] = CreateProlongationMatrix (finelevel);
+      }
+    return prolmats[finelevel];
+  }
+
+  
+  shared_ptr<SparseMatrix< double >> Prolongation :: GetRestrictionMatrix (int finelevel) const
+  {
+    auto prol = GetProlongationMatrix (finelevel);
+    if (!prol) return nullptr;
+    
+    if (!restmats[finelevel])
+      {
+        static Timer t("Prolongation::CreateTranspose"); RegionTimer r(t);
+        restmats[finelevel] = dynamic_pointer_cast<SparseMatrix<double>> (prol->CreateTranspose());
+      }
+    return restmats[finelevel];
+  }
+
+  
+  void Prolongation :: ClearMatrixCache ()
+  {
+    prolmats.SetSize0();
+    restmats.SetSize0();
   }
 
   
@@ -48,26 +105,46 @@ namespace ngmg
       nvlevel.Append (ma->GetNV());
     */
     Prolongation::Update(fes);
-    
+
+    Array<size_t> nvlevel_old = std::move(nvlevel);
     nvlevel.SetSize(ma->GetNLevels());
     for (auto i : Range(nvlevel))
       nvlevel[i] = ma->GetNVLevel(i);
-    
-    if (nvlevel.Size() > 1)
-      {
-        // if we have a transitive dependency within one level
-        // we cannot trivially prolongate in parallel
-        int finelevel = nvlevel.Size()-1;
-        size_t nc = nvlevel[finelevel-1];
-        size_t nf = nvlevel[finelevel];
-        auto & mesh = *ma;        
-        ParallelFor (IntRange(nc, nf), [&mesh, nc, this] (size_t i)
-                     {
-                       auto parents = mesh.GetParentNodes (i);
-                       if (parents[0] >= nc || parents[1] >= nc)
-                         this->allow_parallel = false;
-                     });
-        
+
+    // a new vertex may have a new vertex of the same level as parent
+    // (e.g. adaptive bisection). Vertices of one group depend only on
+    // earlier groups, so each group is prolongated in parallel.
+    // Groups of unchanged levels are kept.
+    vertex_groups.SetSize(nvlevel.Size());
+    for (size_t level = 1; level < nvlevel.Size(); level++)
+      {
+        if (level < nvlevel_old.Size() &&
+            nvlevel_old[level] == nvlevel[level] && nvlevel_old[level-1] == nvlevel[level-1])
+          continue;
+
+        size_t nc = nvlevel[level-1];
+        size_t nf = nvlevel[level];
+        Array<int> group(nf-nc);
+        group = 0;
+        for (size_t i = nc; i < nf; i++)
+          {
+            auto parents = ma->GetParentNodes (i);
+            int g = 0;
+            for (int j = 0; j < 2; j++)
+              if (size_t(parents[j]) >= nc)
+                {
+                  // parents are numbered before their children
+                  NETGEN_CHECK_RANGE(size_t(parents[j]), nc, i);
+                  g = max2(g, group[parents[j]-nc]+1);
+                }
+            group[i-nc] = g;
+          }
+
+        TableCreator<size_t> creator;
+        for ( ; !creator.Done(); creator++)
+          for (size_t i = nc; i < nf; i++)
+            creator.Add (group[i-nc], i);
+        vertex_groups[level] = creator.MoveTable();
       }
   }
 
@@ -75,38 +152,32 @@ namespace ngmg
   void LinearProlongation :: ProlongateInline (int finelevel, BaseVector & v) const
   {
     static Timer t("Prolongate"); RegionTimer r(t);
-    size_t nc = nvlevel[finelevel-1];
     size_t nf = nvlevel[finelevel];
+    auto & mesh = *ma;
     
     if (v.EntrySize() == 1)
       {
         FlatVector<> fv = v.FV<double>();        
         fv.Range (nf, fv.Size()) = 0;
-        if (allow_parallel)
-          {
-            auto & mesh = *ma;
-            ParallelFor (IntRange(nc, nf), [fv, &mesh] (size_t i)
-                         {
-                           auto parents = mesh.GetParentNodes (i);
-                           fv(i) = 0.5 * (fv(parents[0]) + fv(parents[1]));
-                         });
-          }
-        else
-          for (size_t i = nc; i < nf; i++)
-            {
-              auto parents = ma->GetParentNodes (i);
-              fv(i) = 0.5 * (fv(parents[0]) + fv(parents[1]));
-            }
+        for (auto group : vertex_groups[finelevel])
+          ParallelFor (group.Range(), [fv, group, &mesh] (size_t k)
+                       {
+                         size_t i = group[k];
+                         auto parents = mesh.GetParentNodes (i);
+                         fv(i) = 0.5 * (fv(parents[0]) + fv(parents[1]));
+                       });
       }
     else
       {
         FlatSysVector<> sv = v.SV<double>();
         sv.Range (nf, sv.Size()) = 0;
-        for (size_t i = nc; i < nf; i++)
-          {
-            auto parents = ma->GetParentNodes (i);
-            sv(i) = 0.5 * (sv(parents[0]) + sv(parents[1]));
-          }
+        for (auto group : vertex_groups[finelevel])
+          ParallelFor (group.Range(), [sv, group, &mesh] (size_t k)
+                       {
+                         size_t i = group[k];
+                         auto parents = mesh.GetParentNodes (i);
+                         sv(i) = 0.5 * (sv(parents[0]) + sv(parents[1]));
+                       });
       }
   }
 
@@ -116,29 +187,38 @@ namespace ngmg
     static Timer t("Restrict"); RegionTimer r(t);
       
     size_t nc = nvlevel[finelevel-1];
-    size_t nf = nvlevel[finelevel];
-
+    auto & mesh = *ma;
+    auto & groups = vertex_groups[finelevel];
 
+    // vertices of one group may share parents, add atomically
     if (v.EntrySize() == 1)
       {
 	FlatVector<> fv = v.FV<double>();
-	for (size_t i = nf; i-- > nc; )
-	  {
-	    auto parents = ma->GetParentNodes (i);
-	    fv(parents[0]) += 0.5 * fv(i);
-	    fv(parents[1]) += 0.5 * fv(i);
-	  }
+        for (size_t g = groups.Size(); g-- > 0; )
+          ParallelFor (groups[g].Range(), [fv, group=groups[g], &mesh] (size_t k)
+                       {
+                         size_t i = group[k];
+                         auto parents = mesh.GetParentNodes (i);
+                         AtomicAdd (fv(parents[0]), 0.5 * fv(i));
+                         AtomicAdd (fv(parents[1]), 0.5 * fv(i));
+                       });
 	fv.Range(nc, fv.Size()) = 0;          
       }
     else
       {
 	FlatSysVector<> fv = v.SV<double>();
-	for (size_t i = nf; i-- > nc; )
-	  {
-	    auto parents = ma->GetParentNodes (i);
-	    fv(parents[0]) += 0.5 * fv(i);
-	    fv(parents[1]) += 0.5 * fv(i);
-	  }
+        size_t es = v.EntrySize();
+        for (size_t g = groups.Size(); g-- > 0; )
+          ParallelFor (groups[g].Range(), [fv, es, group=groups[g], &mesh] (size_t k)
+                       {
+                         size_t i = group[k];
+                         auto parents = mesh.GetParentNodes (i);
+                         for (size_t j = 0; j < es; j++)
+                           {
+                             AtomicAdd (fv(parents[0])(j), 0.5 * fv(i)(j));
+                             AtomicAdd (fv(parents[1])(j), 0.5 * fv(i)(j));
+                           }
+                       });
 	fv.Range(nc, fv.Size()) = 0;
       }
     /*
@@ -16,6 +16,10 @@ namespace ngmg
   class NGS_DLL_HEADER Prolongation
   {
     Array<DofRange> leveldofs;
+    /// cached level transfer matrices, built on first request
+    mutable Array<shared_ptr<SparseMatrix<double>>> prolmats;
+    /// cached transposed prolongation matrices
+    mutable Array<shared_ptr<SparseMatrix<double>>> restmats;
     
   public:
     ///
@@ -30,6 +34,18 @@ namespace ngmg
 
     ///
     virtual shared_ptr<SparseMatrix< double >> CreateProlongationMatrix( int finelevel ) const = 0;
+    /**
+       cached CreateProlongationMatrix, nullptr if the prolongation has no
+       matrix. Only LinearProlongation builds one, the other prolongations
+       return nullptr and the multigrid preconditioner uses ProlongateInline
+       and RestrictInline. Matrices of a level are dropped by Update if the
+       level is gone or its number of dofs changed.
+    */
+    shared_ptr<SparseMatrix< double >> GetProlongationMatrix (int finelevel) const;
+    /// cached transpose of the prolongation matrix
+    shared_ptr<SparseMatrix< double >> GetRestrictionMatrix (int finelevel) const;
+    /// drop all cached matrices 
+    void ClearMatrixCache ();
     ///
     virtual void ProlongateInline (int finelevel, BaseVector & v) const = 0;
     ///
@@ -80,7 +96,8 @@ namespace ngmg
   {
     shared_ptr<MeshAccess> ma;
     Array<size_t> nvlevel;
-    bool allow_parallel = true;
+    /// new vertices of each level, grouped such that all parents are in earlier groups
+    Array<Table<size_t>> vertex_groups;
   public:
     LinearProlongation(shared_ptr<MeshAccess> ama)
       : ma(ama) { ; }
@@ -947,6 +947,177 @@ namespace ngmg
 
 
 
+  ChebyshevSmoother :: 
+  ChebyshevSmoother  (const MeshAccess & ama,
+                      const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), biform(abiform)
+  {
+    degree = int(flags.GetNumFlag ("chebyshevdegree", 3));
+    ratio = flags.GetNumFlag ("chebyshevratio", 30);
+    safety = flags.GetNumFlag ("chebyshevsafety", 1.1);
+    useblocks = flags.GetDefineFlag ("chebyshevblocks");
+    if (degree < 1)
+      throw Exception ("ChebyshevSmoother: chebyshevdegree must be positive");
+    if (ratio <= 1)
+      throw Exception ("ChebyshevSmoother: chebyshevratio must be larger than 1");
+    Update();
+  }
+
+  ChebyshevSmoother :: ~ChebyshevSmoother()
+  { ; }
+
+  void ChebyshevSmoother :: Update (bool force_update)
+  {
+    static Timer t("ChebyshevSmoother::Update"); RegionTimer reg(t);
+
+    int nlevels = biform.GetNLevels();
+    if (nlevels <= 0) return;
+
+    // the finest level is always updated, coarser ones only once
+    int startlevel = updateall ? 0 : min(int(jac.Size()), nlevels-1);
+    jac.SetSize (nlevels);
+    lmax.SetSize (nlevels);
+
+    auto freedofs = biform.GetFESpace()->GetFreeDofs(biform.UsesEliminateInternal());
+    work_r.SetSize (nlevels);
+    work_d.SetSize (nlevels);
+    
+    for (int level = startlevel; level < nlevels; level++)
+      {
+        shared_ptr<BaseMatrix> mat = biform.GetMatrixPtr(level);
+        jac[level] = nullptr;
+        if (!mat)
+          {
+            work_r[level] = nullptr;
+            work_d[level] = nullptr;
+            continue;
+          }
+
+#ifdef PARALLEL
+        if (auto parmat = dynamic_pointer_cast<ParallelMatrix> (mat))
+          {
+            // the local matrices are distributed: invert the cumulated diagonal
+            if (useblocks)
+              throw Exception ("ChebyshevSmoother: chebyshevblocks is not available for parallel matrices");
+            auto locmat = dynamic_pointer_cast<SparseMatrixTM<double>> (parmat->GetMatrix());
+            if (!locmat)
+              throw Exception ("ChebyshevSmoother: parallel matrix needs a local sparse matrix with double entries");
+
+            auto diag = parmat->CreateColVector();
+            diag.SetParallelStatus (DISTRIBUTED);
+            auto fdiag = diag.FVDouble();
+            for (size_t i = 0; i < locmat->Height(); i++)
+              fdiag(i) = (*locmat)(i,i);
+            diag.Cumulate();
+
+            auto invdiag = make_shared<VVector<double>> (fdiag.Size());
+            for (size_t i = 0; i < fdiag.Size(); i++)
+              (*invdiag)(i) = ((!freedofs || freedofs->Test(i)) && fdiag(i) != 0) ? 1.0/fdiag(i) : 0.0;
+            jac[level] = make_shared<ParallelMatrix> (make_shared<DiagonalMatrix<double>> (invdiag),
+                                                      parmat->GetRowParallelDofs(), D2D);
+          }
+#endif
+        if (!jac[level])
+          {
+            auto & spmat = dynamic_cast<const BaseSparseMatrix&> (*mat);
+            if (useblocks && level == nlevels-1)
+              {
+                Flags blockflags = flags;
+                if (biform.UsesEliminateInternal())
+                  blockflags.SetFlag("eliminate_internal");
+                auto blocks = biform.GetFESpace()->CreateSmoothingBlocks(blockflags);
+                jac[level] = spmat.CreateBlockJacobiPrecond (blocks, 0, true, freedofs);
+              }
+            else
+              jac[level] = spmat.CreateJacobiPrecond (freedofs);
+          }
+
+        lmax[level] = safety * EstimateLargestEigenvalue (biform.GetMatrix(level), *jac[level]);
+        if (lmax[level] <= 0)
+          throw Exception ("ChebyshevSmoother: could not estimate spectral bound on level "
+                           + ToString(level));
+
+        work_r[level] = CreateVector(level);
+        work_d[level] = CreateVector(level);
+        
+        string name = "ChebyshevSmootherLevel" + ToString(level);
+        GetMemoryTracer().Track(*jac[level], name);
+      }
+  }
+
+  /*
+    Chebyshev semi-iteration for the spectral interval [lmax/ratio, lmax]
+    (Saad, Iterative Methods for Sparse Linear Systems, Alg. 12.1)
+   */
+  void ChebyshevSmoother :: Smooth (int level, BaseVector & u, const BaseVector & f) const
+  {
+    const BaseMatrix & mat = biform.GetMatrix(level);
+    const BaseMatrix & pre = *jac[level];
+    
+    double lminl = lmax[level] / ratio;
+    double theta = 0.5 * (lmax[level] + lminl);
+    double delta = 0.5 * (lmax[level] - lminl);
+    double sigma = theta / delta;
+    double rho = 1 / sigma;
+
+    BaseVector & r = *work_r[level];
+    BaseVector & d = *work_d[level];
+
+    r = f - mat * u;
+    pre.Mult (r, d);
+    d *= 1/theta;
+
+    for (int k = 1; k <= degree; k++)
+      {
+        u += d;
+        if (k == degree) break;
+        
+        mat.MultAdd (-1, d, r);
+        double rhonew = 1 / (2*sigma - rho);
+        d *= rhonew * rho;
+        pre.MultAdd (2*rhonew/delta, r, d);
+        rho = rhonew;
+      }
+  }
+
+  void ChebyshevSmoother :: PreSmooth (int level, BaseVector & u, 
+                                       const BaseVector & f, int steps) const
+  {
+    static Timer t("ChebyshevSmoother::Smooth"); RegionTimer reg(t);
+    for (int i = 0; i < steps; i++)
+      Smooth (level, u, f);
+  }
+
+  void ChebyshevSmoother :: PostSmooth (int level, BaseVector & u, 
+                                        const BaseVector & f, int steps) const
+  {
+    // polynomial smoother is symmetric, post-smoothing is the same 
+    PreSmooth (level, u, f, steps);
+  }
+
+  void ChebyshevSmoother :: Residuum (int level, BaseVector & u, 
+                                      const BaseVector & f, BaseVector & d) const
+  {
+    d = f - biform.GetMatrix (level) * u;
+  }
+  
+  AutoVector ChebyshevSmoother :: CreateVector(int level) const
+  {
+    return biform.GetMatrix(level).CreateColVector();
+  }
+
+  Array<MemoryUsage> ChebyshevSmoother :: GetMemoryUsage () const
+  {
+    Array<MemoryUsage> mu;
+    for (int i = 0; i < jac.Size(); i++)
+      if (jac[i]) mu += jac[i]->GetMemoryUsage ();
+    return mu;
+  }
+
+
+
+
+
 
 
 
@@ -226,6 +226,64 @@ namespace ngmg
 
 
 
+  /**
+     Chebyshev polynomial smoother.
+     Needs only matrix-vector products and a point- or block-Jacobi
+     preconditioner, thus it is thread- and MPI-parallel. For parallel
+     matrices the point-Jacobi uses the cumulated diagonal, block-Jacobi
+     is available only for local matrices.
+     The upper spectral bound is estimated by power iteration.
+  */
+  class ChebyshevSmoother : public Smoother
+  {
+    ///
+    const BilinearForm & biform;
+    /// polynomial degree per smoothing step
+    int degree;
+    /// smoothing range is [lmax/ratio, lmax]
+    double ratio;
+    /// safety factor for the estimated lmax
+    double safety;
+    /// block-Jacobi from FESpace smoothing blocks on the finest level
+    bool useblocks;
+    ///
+    Array<shared_ptr<BaseMatrix>> jac;
+    ///
+    Array<double> lmax;
+    /// residual and correction of Smooth, per level
+    Array<shared_ptr<BaseVector>> work_r, work_d;
+  public:
+    ///
+    ChebyshevSmoother (const MeshAccess & ama,
+                       const BilinearForm & abiform, const Flags & aflags);
+    ///
+    virtual ~ChebyshevSmoother();
+  
+    ///
+    virtual void Update (bool force_update = 0);
+    ///
+    virtual void PreSmooth (int level, BaseVector & u, 
+			    const BaseVector & f, int steps) const;
+    ///
+    virtual void PostSmooth (int level, BaseVector & u, 
+			     const BaseVector & f, int steps) const;
+    ///
+    virtual void Residuum (int level, ngla::BaseVector & u, 
+			   const ngla::BaseVector & f, ngla::BaseVector & d) const;
+    ///
+    virtual AutoVector CreateVector(int level) const;
+
+    virtual Array<MemoryUsage> GetMemoryUsage () const;
+
+    /// estimated upper bound of the preconditioned spectrum
+    double GetLambdaMax (int level) const { return lmax[level]; }
+  private:
+    void Smooth (int level, BaseVector & u, const BaseVector & f) const;
+  };
+
+
+
+
 
 #ifdef XXX_OBSOLETE
   /**
@@ -91,6 +91,7 @@ namespace ngstd
 #include "polorder.hpp"
 #include "stringops.hpp"
 #include "statushandler.hpp"
+#include "tracer.hpp"
 
 #ifndef WIN32
 #include "sockets.hpp"
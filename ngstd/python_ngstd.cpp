@@ -132,6 +132,16 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
 	   );
   m.def("ResetTimers", &NgProfiler::Reset);
 
+  m.def("EnableTracing", [] (size_t events_per_thread)
+        { ThreadTrace::Enable(events_per_thread); },
+        py::arg("events_per_thread")=1<<16,
+        "record regions of timers (with TraceRegion) per thread,\n"
+        "buffers are ring-buffers, the oldest events are overwritten");
+  m.def("DisableTracing", &ThreadTrace::Disable);
+  m.def("ClearTracing", &ThreadTrace::Clear);
+  m.def("WriteChromeTrace", &ThreadTrace::WriteChromeTrace, py::arg("filename"),
+        "write recorded regions as Chrome-trace json (chrome://tracing, ui.perfetto.dev)");
+
   
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
       /*
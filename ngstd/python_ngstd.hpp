@@ -119,6 +119,13 @@ public:
 
 
 
+/*
+  GIL policy: long running C++ entry points release the GIL
+  (py::call_guard<py::gil_scoped_release> or a ReleaseGIL scope after the
+  arguments are extracted). Every C++ object which calls back into Python
+  (trampolines, python preconditioners, python callbacks) acquires the GIL
+  itself, so it is safe to be called from a released region.
+*/
 typedef py::gil_scoped_acquire AcquireGIL; 
 typedef py::gil_scoped_release ReleaseGIL; 
 
@@ -0,0 +1,172 @@
+/**************************************************************************/
+/* File:   tracer.cpp                                                     */
+/**************************************************************************/
+
+#include <ngstd.hpp>
+#include <fstream>
+
+namespace ngstd
+{
+  std::atomic<bool> ThreadTrace::enabled{false};
+  Array<ThreadTrace::Buffer> ThreadTrace::buffers;
+  TTimePoint ThreadTrace::start_time = 0;
+
+  void ThreadTrace :: Enable (size_t events_per_thread)
+  {
+    size_t size = 1;
+    while (size < events_per_thread) size *= 2;
+
+    size_t nthreads = max(TaskManager::GetMaxThreads(), 1);
+    if (buffers.Size() != nthreads || (buffers.Size() && buffers[0].events.Size() != size))
+      {
+        buffers = Array<Buffer>(nthreads);
+        for (auto & buf : buffers)
+          buf.events.SetSize(size);
+        start_time = GetTimeCounter();
+      }
+    enabled = true;
+  }
+
+  void ThreadTrace :: Disable ()
+  {
+    enabled = false;
+  }
+
+  void ThreadTrace :: Clear ()
+  {
+    for (auto & buf : buffers)
+      {
+        buf.cnt = 0;
+        buf.depth = 0;
+      }
+    start_time = GetTimeCounter();
+  }
+
+  size_t ThreadTrace :: NumEvents ()
+  {
+    size_t sum = 0;
+    for (auto & buf : buffers)
+      sum += min(buf.cnt, buf.events.Size());
+    return sum;
+  }
+
+  size_t ThreadTrace :: NumLostEvents ()
+  {
+    size_t sum = 0;
+    for (auto & buf : buffers)
+      if (buf.cnt > buf.events.Size())
+        sum += buf.cnt - buf.events.Size();
+    return sum;
+  }
+
+
+  static string JsonEscape (const string & str)
+  {
+    string res;
+    for (char c : str)
+      switch (c)
+        {
+        case '"': res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\t': res += "\\t"; break;
+        default:
+          if ((unsigned char)(c) < 0x20) res += ' ';
+          else res += c;
+        }
+    return res;
+  }
+
+  void ThreadTrace :: WriteChromeTrace (const string & filename)
+  {
+    static Timer t("ThreadTrace::WriteChromeTrace"); RegionTimer reg(t);
+
+    int rank = 0, ntasks = 1;
+#ifdef PARALLEL
+    NgMPI_Comm comm(MPI_COMM_WORLD);
+    rank = comm.Rank();
+    ntasks = comm.Size();
+#endif // PARALLEL
+
+    string name = filename;
+    if (ntasks > 1)
+      name += "_" + ToString(rank);
+    ofstream out(name);
+    if (!out)
+      throw Exception ("ThreadTrace: cannot open file " + name);
+    out.precision(15);
+
+    auto ToMicroSeconds = [] (TTimePoint ticks)
+      { return 1e6 * seconds_per_tick * double(ticks); };
+
+    Array<bool> used_timers(NgProfiler::SIZE);
+    used_timers = false;
+
+    out << "{\n\"displayTimeUnit\": \"ns\",\n\"traceEvents\": [\n";
+    bool first = true;
+    auto Separator = [&] () -> ostream&
+      {
+        if (!first) out << ",\n";
+        first = false;
+        return out;
+      };
+
+    Separator() << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << rank
+                << ", \"args\": {\"name\": \"rank " << rank << "\"}}";
+
+    for (size_t tid = 0; tid < buffers.Size(); tid++)
+      {
+        auto & buf = buffers[tid];
+        size_t size = buf.events.Size();
+        size_t num = min(buf.cnt, size);
+        if (num == 0) continue;
+
+        Separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << rank
+                    << ", \"tid\": " << tid
+                    << ", \"args\": {\"name\": \"thread " << tid << "\"}}";
+
+        // oldest event first
+        for (size_t i = buf.cnt-num; i < buf.cnt; i++)
+          {
+            const Event & ev = buf.events[i & (size-1)];
+            if (ev.start < start_time) continue;
+
+            bool valid = ev.timernr >= 0 && ev.timernr < NgProfiler::SIZE;
+            if (valid) used_timers[ev.timernr] = true;
+            string evname = valid ? NgProfiler::timers[ev.timernr].name : string("timer ")+ToString(ev.timernr);
+            double dur = ToMicroSeconds(ev.stop-ev.start);
+
+            Separator() << "{\"name\": \"" << JsonEscape(evname) << "\", \"cat\": \"ngsolve\", \"ph\": \"X\""
+                        << ", \"pid\": " << rank << ", \"tid\": " << tid
+                        << ", \"ts\": " << ToMicroSeconds(ev.start-start_time)
+                        << ", \"dur\": " << dur
+                        << ", \"args\": {\"depth\": " << ev.depth;
+            if (ev.flops > 0)
+              {
+                out << ", \"flops\": " << ev.flops;
+                if (dur > 0) out << ", \"GFlop/s\": " << ev.flops / dur * 1e-3;
+              }
+            if (ev.bytes > 0)
+              {
+                out << ", \"bytes\": " << ev.bytes;
+                if (dur > 0) out << ", \"GB/s\": " << ev.bytes / dur * 1e-3;
+              }
+            out << "}}";
+          }
+      }
+    out << "\n],\n";
+
+    // accumulated timer data, as from ngsolve.Timers()
+    out << "\"timers\": [\n";
+    first = true;
+    for (int nr = 0; nr < NgProfiler::SIZE; nr++)
+      if (used_timers[nr])
+        Separator() << "{\"name\": \"" << JsonEscape(NgProfiler::timers[nr].name) << "\""
+                    << ", \"time\": " << NgProfiler::GetTime(nr)
+                    << ", \"counts\": " << NgProfiler::GetCounts(nr)
+                    << ", \"flops\": " << NgProfiler::GetFlops(nr) << "}";
+    out << "\n],\n";
+    out << "\"otherData\": {\"lost_events\": \"" << NumLostEvents() << "\"}\n}\n";
+  }
+
+}
@@ -0,0 +1,127 @@
+#ifndef FILE_NGSTD_TRACER
+#define FILE_NGSTD_TRACER
+
+/**************************************************************************/
+/* File:   tracer.hpp                                                     */
+/**************************************************************************/
+
+/*
+  Per-thread region tracing with Chrome-trace export
+*/
+
+namespace ngstd
+{
+
+  /**
+     Records nested regions (start/stop ticks, timer number, flops, bytes)
+     into per-thread ring buffers. Every thread writes only into its own
+     buffer, there are no locks or atomic read-modify-writes on the hot path.
+     When tracing is disabled, a TraceRegion costs one relaxed load of a flag.
+     If a buffer overflows, the oldest events are overwritten.
+
+     The result is written as Chrome-trace JSON, which can be inspected with
+     chrome://tracing or ui.perfetto.dev.
+
+     Enable/Disable should be called outside of parallel regions.
+  */
+  class NGS_DLL_HEADER ThreadTrace
+  {
+  public:
+    struct Event
+    {
+      TTimePoint start, stop;
+      double flops;
+      size_t bytes;
+      int timernr;
+      int depth;
+    };
+
+  private:
+    struct alignas(64) Buffer
+    {
+      Array<Event> events;    // size is a power of 2
+      size_t cnt = 0;         // number of events recorded, including overwritten
+      int depth = 0;
+    };
+
+    static std::atomic<bool> enabled;
+    static Array<Buffer> buffers;
+    static TTimePoint start_time;
+
+  public:
+    /// allocates buffers for all threads of the task-manager and starts recording
+    static void Enable (size_t events_per_thread = 1 << 16);
+    /// stops recording, recorded events are kept for output
+    static void Disable ();
+    static void Clear ();
+    static bool IsEnabled () { return enabled.load(std::memory_order_relaxed); }
+
+    /// number of recorded events, and overwritten ones
+    static size_t NumEvents ();
+    static size_t NumLostEvents ();
+
+    /// writes a Chrome-trace json file, with MPI the rank is appended to the filename
+    static void WriteChromeTrace (const string & filename);
+
+    static bool Begin (int tid, int & depth)
+    {
+      if (size_t(tid) >= buffers.Size()) return false;
+      depth = buffers[tid].depth++;
+      return true;
+    }
+
+    static void End (int tid, int timernr, int depth, TTimePoint start,
+                     double flops, size_t bytes)
+    {
+      TTimePoint stop = GetTimeCounter();
+      if (size_t(tid) >= buffers.Size()) return;
+      Buffer & buf = buffers[tid];
+      if (buf.depth > 0) buf.depth--;
+      if (buf.events.Size() == 0) return;
+      buf.events[buf.cnt++ & (buf.events.Size()-1)] = Event { start, stop, flops, bytes, timernr, depth };
+    }
+  };
+
+
+  /**
+     Traces a region of a Timer. Use next to the RegionTimer,
+     or alone for timers with NoTracing.
+
+     static Timer t("MyFunction"); TraceRegion tr(t);
+  */
+  class TraceRegion
+  {
+    int tid = -1;
+    int timernr;
+    int depth;
+    TTimePoint start;
+    double flops = 0;
+    size_t bytes = 0;
+  public:
+    TraceRegion (int atimernr)
+      : timernr(atimernr)
+    {
+      if (!ThreadTrace::IsEnabled()) return;
+      int mytid = TaskManager::GetThreadId();
+      if (!ThreadTrace::Begin(mytid, depth)) return;
+      tid = mytid;
+      start = GetTimeCounter();
+    }
+
+    ~TraceRegion ()
+    {
+      if (tid >= 0)
+        ThreadTrace::End (tid, timernr, depth, start, flops, bytes);
+    }
+
+    TraceRegion (const TraceRegion &) = delete;
+    void operator= (const TraceRegion &) = delete;
+
+    bool Active () const { return tid >= 0; }
+    void AddFlops (double aflops) { flops += aflops; }
+    void AddBytes (size_t abytes) { bytes += abytes; }
+  };
+
+}
+
+#endif
@@ -0,0 +1,282 @@
+/*********************************************************************/
+/* File:   parallel_schwarz.cpp                                      */
+/*********************************************************************/
+
+/*
+   Two-level overlapping Schwarz preconditioner
+*/
+
+#include <la.hpp>
+#include <parallelngs.hpp>
+
+
+namespace ngla
+{
+
+  ParallelSchwarzPrecond ::
+  ParallelSchwarzPrecond (shared_ptr<BaseMatrix> amat, shared_ptr<BitArray> afreedofs,
+                          bool arestricted, bool acoarse, string inversetype)
+    : BaseMatrix(amat->GetParallelDofs()), mat(amat), freedofs(afreedofs),
+      restricted(arestricted), coarse(acoarse)
+  {
+    static Timer t("ParallelSchwarz - setup"); RegionTimer rt(t);
+
+    shared_ptr<BaseMatrix> hmat = mat;
+    if (auto parmat = dynamic_pointer_cast<ParallelMatrix> (mat))
+      hmat = parmat->GetMatrix();
+    locmat = dynamic_pointer_cast<SparseMatrixTM<double>> (hmat);
+    if (!locmat)
+      throw Exception (string("ParallelSchwarzPrecond needs a sparse matrix with double entries, got ")
+                       + typeid(*hmat).name());
+
+    bool distributed = paralleldofs && paralleldofs->GetCommunicator().Size() > 1;
+    size_t ndof = locmat->Height();
+    weight.SetSize (ndof);
+    for (size_t d = 0; d < ndof; d++)
+      weight[d] = distributed ? 1.0 / (1+paralleldofs->GetDistantProcs(d).Size()) : 1.0;
+
+    if (!distributed)
+      {
+        // one subdomain
+        restricted = false;
+        coarse = false;
+      }
+
+    if (coarse)
+      SetupCoarseSpace();
+    SetupSubdomainMatrix (inversetype);
+
+    hx = make_shared<VVector<double>> (ndof);
+    hy = make_shared<VVector<double>> (ndof);
+  }
+
+
+  void ParallelSchwarzPrecond :: SetupSubdomainMatrix (const string & inversetype)
+  {
+    static Timer t("ParallelSchwarz - subdomain matrix"); RegionTimer rt(t);
+    static Timer tinv("ParallelSchwarz - factor");
+
+    submat = locmat;
+
+#ifdef PARALLEL
+    if (paralleldofs && paralleldofs->GetCommunicator().Size() > 1)
+      {
+        auto & comm = paralleldofs->GetCommunicator();
+        auto procs = paralleldofs->GetDistantProcs();
+        bool symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double>> (locmat) != nullptr;
+        size_t ndof = locmat->Height();
+
+        // local entries at pairs of dofs shared with proc p. Dofs are sent as
+        // position in the exchange dofs, which have the same order on both procs
+        Array<int> expos(ndof);
+        expos = -1;
+        Array<Array<int>> send_ind(procs.Size()), recv_ind(procs.Size());
+        Array<Array<double>> send_val(procs.Size()), recv_val(procs.Size());
+        for (auto i : Range(procs))
+          {
+            auto exdofs = paralleldofs->GetExchangeDofs(procs[i]);
+            for (auto k : Range(exdofs))
+              expos[exdofs[k]] = k;
+            for (auto k : Range(exdofs))
+              {
+                auto cols = locmat->GetRowIndices(exdofs[k]);
+                auto vals = locmat->GetRowValues(exdofs[k]);
+                for (auto j : Range(cols))
+                  if (expos[cols[j]] != -1)
+                    {
+                      send_ind[i].Append (k);
+                      send_ind[i].Append (expos[cols[j]]);
+                      send_val[i].Append (vals[j]);
+                    }
+              }
+            for (auto d : exdofs)
+              expos[d] = -1;
+          }
+
+        Array<MPI_Request> requests;
+        for (auto i : Range(procs))
+          {
+            requests.Append (comm.ISend (send_ind[i], procs[i], MPI_TAG_SOLVE));
+            requests.Append (comm.ISend (send_val[i], procs[i], MPI_TAG_SOLVE));
+          }
+        for (auto i : Range(procs))
+          {
+            comm.Recv (recv_ind[i], procs[i], MPI_TAG_SOLVE);
+            comm.Recv (recv_val[i], procs[i], MPI_TAG_SOLVE);
+          }
+        MyMPI_WaitAll (requests);
+
+        // R_i A R_i^T = local matrix + entries of all neighbours sharing both dofs
+        DynamicTable<int> graph(ndof);
+        for (size_t r = 0; r < ndof; r++)
+          for (auto c : locmat->GetRowIndices(r))
+            graph.AddUnique (r, c);
+        for (auto i : Range(procs))
+          {
+            auto exdofs = paralleldofs->GetExchangeDofs(procs[i]);
+            for (size_t j = 0; j < recv_val[i].Size(); j++)
+              {
+                int r = exdofs[recv_ind[i][2*j]], c = exdofs[recv_ind[i][2*j+1]];
+                if (symmetric && r < c) swap (r, c);
+                graph.AddUnique (r, c);
+              }
+          }
+
+        Array<int> els_per_row(ndof);
+        for (size_t r = 0; r < ndof; r++)
+          els_per_row[r] = graph[r].Size();
+
+        auto matrix = symmetric ? make_shared<SparseMatrixSymmetric<double>> (els_per_row)
+          : make_shared<SparseMatrix<double>> (els_per_row);
+        for (size_t r = 0; r < ndof; r++)
+          for (auto c : graph[r])
+            matrix->CreatePosition (r, c);
+        matrix->AsVector() = 0.0;
+
+        for (size_t r = 0; r < ndof; r++)
+          {
+            auto cols = locmat->GetRowIndices(r);
+            auto vals = locmat->GetRowValues(r);
+            for (auto j : Range(cols))
+              (*matrix)(r, cols[j]) += vals[j];
+          }
+        for (auto i : Range(procs))
+          {
+            auto exdofs = paralleldofs->GetExchangeDofs(procs[i]);
+            for (size_t j = 0; j < recv_val[i].Size(); j++)
+              {
+                int r = exdofs[recv_ind[i][2*j]], c = exdofs[recv_ind[i][2*j+1]];
+                if (symmetric && r < c) swap (r, c);
+                (*matrix)(r, c) += recv_val[i][j];
+              }
+          }
+        submat = matrix;
+      }
+#endif
+
+    RegionTimer rtinv(tinv);
+    submat->SetInverseType (inversetype);
+    locinv = submat->InverseMatrix (freedofs);
+  }
+
+
+  void ParallelSchwarzPrecond :: SetupCoarseSpace ()
+  {
+#ifdef PARALLEL
+    static Timer t("ParallelSchwarz - coarse space"); RegionTimer rt(t);
+
+    auto & comm = paralleldofs->GetCommunicator();
+    int ntasks = comm.Size();
+    size_t ndof = locmat->Height();
+
+    // coarse functions which do not vanish on this rank
+    Array<int> procs;
+    procs.Append (comm.Rank());
+    for (auto p : paralleldofs->GetDistantProcs())
+      procs.Append (p);
+
+    Matrix<> z(procs.Size(), ndof);
+    z = 0.0;
+    for (size_t d = 0; d < ndof; d++)
+      if (!freedofs || freedofs->Test(d))
+        {
+          z(0, d) = weight[d];
+          for (auto p : paralleldofs->GetDistantProcs(d))
+            z(procs.Pos(p), d) = weight[d];
+        }
+
+    // E = Z^T A Z, with A the sum of the local matrices
+    Matrix<> ecoarse(ntasks);
+    ecoarse = 0.0;
+    VVector<double> hv(ndof), hu(ndof);
+    for (auto k : Range(procs))
+      {
+        hv.FV() = z.Row(k);
+        locmat->Mult (hv, hu);
+        for (auto j : Range(procs))
+          ecoarse(procs[j], procs[k]) += InnerProduct (z.Row(j), hu.FV());
+      }
+    MPI_Allreduce (MPI_IN_PLACE, ecoarse.Data(), ntasks*ntasks, MPI_DOUBLE, MPI_SUM, comm);
+
+    // ranks without free dofs
+    for (int i = 0; i < ntasks; i++)
+      if (ecoarse(i,i) == 0.0)
+        ecoarse(i,i) = 1.0;
+
+    coarse_inv.SetSize (ntasks, ntasks);
+    coarse_inv = ecoarse;
+    CalcInverse (coarse_inv);
+#endif
+  }
+
+
+  void ParallelSchwarzPrecond :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+
+  void ParallelSchwarzPrecond :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("ParallelSchwarz - apply"); RegionTimer rt(t);
+    static Timer tloc("ParallelSchwarz - subdomain solve");
+    static Timer tcoarse("ParallelSchwarz - coarse solve");
+
+    x.Cumulate();
+    y.Distribute();
+    auto fx = x.FVDouble();
+    auto fy = y.FVDouble();
+    size_t ndof = fx.Size();
+
+    tloc.Start();
+    hx->FVDouble() = fx;
+    locinv->Mult (*hx, *hy);
+    auto fhy = hy->FVDouble();
+    if (restricted)
+      ParallelForRange (ndof, [&] (IntRange r)
+                        {
+                          for (auto d : r)
+                            fy(d) += s * weight[d] * fhy(d);
+                        });
+    else
+      ParallelForRange (ndof, [&] (IntRange r)
+                        { fy.Range(r) += s * fhy.Range(r); });
+    tloc.Stop();
+
+#ifdef PARALLEL
+    if (coarse_inv.Height())
+      {
+        RegionTimer rtc(tcoarse);
+        auto & comm = paralleldofs->GetCommunicator();
+        int me = comm.Rank();
+
+        // x is cumulated, count every dof on its master only
+        Vector<> c(coarse_inv.Height());
+        c = 0.0;
+        for (size_t d = 0; d < ndof; d++)
+          if ((!freedofs || freedofs->Test(d)) && paralleldofs->IsMasterDof(d))
+            {
+              double wx = weight[d] * fx(d);
+              c(me) += wx;
+              for (auto p : paralleldofs->GetDistantProcs(d))
+                c(p) += wx;
+            }
+        MPI_Allreduce (MPI_IN_PLACE, c.Data(), c.Size(), MPI_DOUBLE, MPI_SUM, comm);
+
+        Vector<> yc = coarse_inv * c;
+
+        // y is distributed, add the coarse correction on the master dofs
+        for (size_t d = 0; d < ndof; d++)
+          if ((!freedofs || freedofs->Test(d)) && paralleldofs->IsMasterDof(d))
+            {
+              double sum = yc(me);
+              for (auto p : paralleldofs->GetDistantProcs(d))
+                sum += yc(p);
+              fy(d) += s * weight[d] * sum;
+            }
+      }
+#endif
+  }
+
+}
@@ -0,0 +1,76 @@
+#ifndef FILE_NGS_PARALLEL_SCHWARZ
+#define FILE_NGS_PARALLEL_SCHWARZ
+
+/* ************************************************************************/
+/* File:   parallel_schwarz.hpp                                           */
+/* ************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Two-level overlapping Schwarz preconditioner.
+
+     Every rank is one subdomain, consisting of all its local dofs.
+     Dofs shared with neighbours form the overlap. This is the minimal
+     overlap given by the mesh partition; subdomains are not extended by
+     further layers of neighbour dofs, so the overlap does not grow with
+     the problem size and the iteration counts increase under refinement
+     roughly like the one-level method with small overlap. The subdomain matrix
+     is the exact restriction R_i A R_i^T. It is obtained from the local
+     matrix by adding the entries of all neighbours at pairs of shared dofs.
+     It is factorized with the local (threaded) sparse direct solver.
+
+     restricted ... restricted additive Schwarz: the local solutions are
+                    weighted by the partition of unity 1/(number of procs
+                    sharing the dof). Not symmetric.
+     coarse ... additive coarse space of dimension (number of ranks),
+                one function per subdomain given by the partition of unity
+                (Nicolaides). The coarse matrix is dense and factorized
+                on every rank.
+
+     Without MPI (or on a single rank) this is the direct solver.
+  */
+  class NGS_DLL_HEADER ParallelSchwarzPrecond : public BaseMatrix
+  {
+    shared_ptr<BaseMatrix> mat;
+    /// local matrix of mat, and the subdomain matrix
+    shared_ptr<SparseMatrixTM<double>> locmat, submat;
+    shared_ptr<BitArray> freedofs;
+    shared_ptr<BaseMatrix> locinv;
+    bool restricted;
+    bool coarse;
+
+    /// partition of unity, 1 / number of procs sharing the dof
+    Array<double> weight;
+    /// inverse coarse matrix
+    Matrix<double> coarse_inv;
+    /// work vectors for the subdomain solve
+    shared_ptr<BaseVector> hx, hy;
+
+    void SetupSubdomainMatrix (const string & inversetype);
+    void SetupCoarseSpace ();
+
+  public:
+    /// amat is a ParallelMatrix over a local SparseMatrix<double>, or a SparseMatrix<double>
+    ParallelSchwarzPrecond (shared_ptr<BaseMatrix> amat, shared_ptr<BitArray> afreedofs,
+                            bool arestricted = false, bool acoarse = true,
+                            string inversetype = "sparsecholesky");
+
+    virtual bool IsComplex() const override { return false; }
+    virtual int VHeight() const override { return locmat->Height(); }
+    virtual int VWidth() const override { return locmat->Width(); }
+    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// the subdomain matrix R_i A R_i^T of this rank
+    shared_ptr<SparseMatrixTM<double>> GetSubdomainMatrix() const { return submat; }
+    int GetCoarseDim() const { return coarse_inv.Height(); }
+  };
+
+}
+
+#endif
@@ -13,6 +13,7 @@ namespace ngparallel
 
 #include "parallelvector.hpp"
 #include "parallel_matrices.hpp"
+#include "parallel_schwarz.hpp"
 
 
 #endif
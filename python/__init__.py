@@ -61,7 +61,8 @@ from .comp import VOL, BND, BBND, BBBND, COUPLING_TYPE, ElementId, \
     CompressCompound, BoundaryFromVolumeCF, Interpolate, Variation, \
     NumProc, PDE, Integrate, Region, SymbolicLFI, SymbolicBFI, \
     SymbolicEnergy, Mesh, NodeId, ConvertOperator, ORDER_POLICY, VTKOutput, SetHeapSize, \
-    SetTestoutFile, ngsglobals, pml, MPI_Init, ContactBoundary, PatchwiseSolve
+    SetTestoutFile, ngsglobals, pml, MPI_Init, ContactBoundary, PatchwiseSolve, \
+    CFIntegrator, SetValuesInterpolator, ExplicitTimeStepper
 from .solve import BVP, CalcFlux, Draw, DrawFlux, \
     SetVisualization
 from .utils import x, y, z, dx, ds, grad, Grad, curl, div, Deviator, PyId, PyTrace, \
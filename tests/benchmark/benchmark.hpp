@@ -0,0 +1,71 @@
+#ifndef FILE_NGS_BENCHMARK
+#define FILE_NGS_BENCHMARK
+
+/*
+  Minimal benchmark harness for the performance regression suite.
+
+  A benchmark case sets up its data for a given problem size and returns
+  the kernel which is timed. The driver (main.cpp) runs all cases for all
+  sizes and thread counts, writes the results as json and compares them
+  to a stored baseline.
+*/
+
+#include <comp.hpp>
+
+namespace ngs_benchmark
+{
+  using namespace ngcomp;
+
+  struct ProblemSize
+  {
+    string name;
+    int refinements;      // uniform refinements of the cube mesh
+    int order;
+  };
+
+  struct Setup
+  {
+    /// timed kernel
+    function<void()> kernel;
+    /// work of one call for rate output, e.g. flops, bytes or dofs (0 = none)
+    double work = 0;
+    string work_unit;
+  };
+
+  struct BenchmarkCase
+  {
+    string name;
+    /// only run for the first maxsize problem sizes (expensive cases)
+    int maxsize;
+    function<Setup(shared_ptr<MeshAccess>, const ProblemSize &, LocalHeap &)> setup;
+  };
+
+  Array<BenchmarkCase> & GetBenchmarkCases();
+
+  class RegisterBenchmark
+  {
+  public:
+    RegisterBenchmark (string name,
+                       function<Setup(shared_ptr<MeshAccess>, const ProblemSize &, LocalHeap &)> setup,
+                       int maxsize = 100)
+    {
+      GetBenchmarkCases().Append (BenchmarkCase { name, maxsize, setup });
+    }
+  };
+
+  struct Result
+  {
+    string name;
+    string size;
+    int threads;
+    double time;       // median over runs
+    double mintime;
+    int runs;
+    double work;
+    string work_unit;
+
+    string Key() const { return name + "/" + size + "/" + ToString(threads); }
+  };
+}
+
+#endif
@@ -0,0 +1,203 @@
+/*
+  Benchmark cases for the hot paths: assembly, static condensation, SpMV
+  (flops and memory bandwidth), sparse Cholesky, block-Jacobi smoothing,
+  CoefficientFunction compile and evaluate, VTK output and vector
+  operations, shared memory and (run with mpirun) distributed.
+*/
+
+#include "benchmark.hpp"
+#include <vtkoutput.hpp>
+
+namespace ngs_benchmark
+{
+  Array<BenchmarkCase> & GetBenchmarkCases()
+  {
+    static Array<BenchmarkCase> cases;
+    return cases;
+  }
+
+  static shared_ptr<FESpace> MakeH1 (shared_ptr<MeshAccess> ma, int order)
+  {
+    Flags flags;
+    flags.SetFlag ("order", double(order));
+    auto fes = CreateFESpace ("h1ho", ma, flags);
+    fes->Update();
+    fes->FinalizeUpdate();
+    return fes;
+  }
+
+  static shared_ptr<BilinearForm> MakeLaplace (shared_ptr<FESpace> fes, bool condense = false)
+  {
+    Flags flags;
+    flags.SetFlag ("symmetric");
+    if (condense)
+      flags.SetFlag ("condense");
+    auto bf = CreateBilinearForm (fes, "a", flags);
+    shared_ptr<CoefficientFunction> one = make_shared<ConstantCoefficientFunction> (1);
+    bf->AddIntegrator (GetIntegrators().CreateBFI ("laplace", fes->GetMeshAccess()->GetDimension(), one));
+    bf->AddIntegrator (GetIntegrators().CreateBFI ("mass", fes->GetMeshAccess()->GetDimension(), one));
+    return bf;
+  }
+
+  static shared_ptr<CoefficientFunction> TestCF (int dim)
+  {
+    auto x = MakeCoordinateCoefficientFunction(0);
+    auto y = MakeCoordinateCoefficientFunction(1);
+    auto z = MakeCoordinateCoefficientFunction(dim > 2 ? 2 : 0);
+    shared_ptr<CoefficientFunction> one = make_shared<ConstantCoefficientFunction>(1);
+    return x*y*z + x*x*y + one + z*z*z*x + (one+x)*(one+y)*(one+z);
+  }
+
+
+  static RegisterBenchmark bench_assemble
+  ("Assemble", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes);
+     return Setup { [bf, &lh] () { bf->Assemble(lh); }, double(fes->GetNDof()), "dofs" };
+   });
+
+  static RegisterBenchmark bench_condense
+  ("AssembleCondensed", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes, true);
+     return Setup { [bf, &lh] () { bf->Assemble(lh); }, double(fes->GetNDof()), "dofs" };
+   });
+
+  static RegisterBenchmark bench_spmv
+  ("SpMV", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes);
+     bf->Assemble(lh);
+     auto mat = bf->GetMatrixPtr();
+     shared_ptr<BaseVector> x = mat->CreateRowVector();
+     shared_ptr<BaseVector> y = mat->CreateColVector();
+     x->SetRandom();
+     double nze = dynamic_pointer_cast<BaseSparseMatrix>(mat) ?
+       dynamic_pointer_cast<BaseSparseMatrix>(mat)->NZE() : 0;
+     return Setup { [mat, x, y] () { mat->Mult(*x, *y); }, 2*nze, "flop" };
+   });
+
+  static RegisterBenchmark bench_spmv_bandwidth
+  ("SpMVBandwidth", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     // memory bound: values, column numbers, and the vectors
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes);
+     bf->Assemble(lh);
+     auto mat = dynamic_pointer_cast<BaseSparseMatrix> (bf->GetMatrixPtr());
+     if (!mat)
+       throw Exception ("SpMVBandwidth: need a sparse matrix");
+     shared_ptr<BaseVector> x = mat->CreateRowVector();
+     shared_ptr<BaseVector> y = mat->CreateColVector();
+     x->SetRandom();
+     double bytes = mat->NZE() * (sizeof(double)+sizeof(int)) + 3.0 * sizeof(double) * mat->Height();
+     return Setup { [mat, x, y] () { mat->Mult(*x, *y); }, bytes, "bytes" };
+   });
+
+  static RegisterBenchmark bench_cholesky
+  ("SparseCholesky", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes, true);
+     bf->Assemble(lh);
+     auto mat = bf->GetMatrixPtr();
+     mat->SetInverseType (SPARSECHOLESKY);
+     auto freedofs = fes->GetFreeDofs(true);
+     return Setup { [mat, freedofs] () { mat->InverseMatrix(freedofs); }, double(fes->GetNDof()), "dofs" };
+   }, 2);
+
+  static RegisterBenchmark bench_blockjacobi
+  ("BlockJacobiSmooth", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes);
+     bf->Assemble(lh);
+     auto mat = dynamic_pointer_cast<BaseSparseMatrix> (bf->GetMatrixPtr());
+     if (!mat)
+       throw Exception ("BlockJacobiSmooth: need a sparse matrix");
+     auto blocks = fes->CreateSmoothingBlocks (Flags());
+     shared_ptr<BaseBlockJacobiPrecond> bj = mat->CreateBlockJacobiPrecond (blocks);
+     shared_ptr<BaseVector> x = mat->CreateColVector();
+     shared_ptr<BaseVector> b = mat->CreateColVector();
+     b->SetRandom();
+     *x = 0.0;
+     return Setup { [bj, x, b] () { bj->GSSmooth (*x, *b, 1); }, double(mat->NZE()), "nze" };
+   });
+
+  static RegisterBenchmark bench_cfcompile
+  ("CFCompile", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     auto cf = TestCF (ma->GetDimension());
+     return Setup { [cf] () { Compile (cf, false); } };
+   }, 1);
+
+  static RegisterBenchmark bench_cfevaluate
+  ("CFEvaluate", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     Array<shared_ptr<CoefficientFunction>> cfs { TestCF (ma->GetDimension()) };
+     auto integrator = make_shared<CFIntegrator> (ma, VOL, cfs, 2*ps.order);
+     return Setup { [integrator, &lh] () { integrator->Integrate(lh); }, double(ma->GetNE(VOL)), "elements" };
+   });
+
+  static RegisterBenchmark bench_vtk
+  ("VTKOutput", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     if (ma->GetDimension() != 3)
+       throw Exception ("VTKOutput benchmark needs a 3D mesh");
+     Array<shared_ptr<CoefficientFunction>> cfs { TestCF (3) };
+     Array<string> names { "f" };
+     auto vtk = make_shared<VTKOutput<3>> (ma, cfs, names, "benchmark_vtk", 1, -1, "double", false, 1);
+     return Setup { [vtk, &lh] () { vtk->Do(lh); }, double(ma->GetNE(VOL)), "elements" };
+   }, 2);
+
+  static RegisterBenchmark bench_vectorops
+  ("VectorOps", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     // inner product and axpy, shared memory parallel only
+     auto fes = MakeH1 (ma, ps.order);
+     auto bf = MakeLaplace (fes);
+     bf->Assemble(lh);
+     shared_ptr<BaseVector> x = bf->GetMatrix().CreateColVector();
+     shared_ptr<BaseVector> y = bf->GetMatrix().CreateColVector();
+     x->SetRandom();
+     y->SetRandom();
+     return Setup { [x, y] ()
+                    {
+                      double ip = InnerProduct<double> (*x, *y);
+                      y->Add (1e-3/(1+fabs(ip)), *x);
+                    },
+                    4.0*x->FVDouble().Size(), "flop" };
+   });
+
+#ifdef PARALLEL
+  static RegisterBenchmark bench_vectorops_distributed
+  ("VectorOpsDistributed", [] (shared_ptr<MeshAccess> ma, const ProblemSize & ps, LocalHeap & lh)
+   {
+     // ParallelVectors on the partitioned mesh: the inner product of a cumulated
+     // and a distributed vector needs one AllReduce, adding cumulated vectors is local
+     auto fes = MakeH1 (ma, ps.order);
+     if (!fes->IsParallel())
+       throw Exception ("VectorOpsDistributed needs a distributed mesh, run with mpirun");
+     auto bf = MakeLaplace (fes);
+     bf->Assemble(lh);
+     shared_ptr<BaseVector> x = bf->GetMatrix().CreateColVector();
+     shared_ptr<BaseVector> y = bf->GetMatrix().CreateColVector();
+     shared_ptr<BaseVector> z = bf->GetMatrix().CreateColVector();
+     x->SetRandom();
+     x->SetParallelStatus (DISTRIBUTED);
+     x->Cumulate();
+     y->SetRandom();
+     y->SetParallelStatus (DISTRIBUTED);
+     *z = *x;
+     return Setup { [x, y, z] ()
+                    {
+                      double ip = InnerProduct<double> (*x, *y);
+                      z->Add (1e-3/(1+fabs(ip)), *x);
+                    },
+                    4.0*fes->GetNDofGlobal(), "flop" };
+   });
+#endif
+}
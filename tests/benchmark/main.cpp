@@ -0,0 +1,262 @@
+/*
+  ngs_benchmark: runs the benchmark cases for several problem sizes and
+  thread counts, writes the results as json, and compares them to a
+  baseline file written by an earlier run.
+
+  ngs_benchmark [--sizes small,medium,large] [--threads 1,8] [--filter name]
+                [--output results.json] [--baseline baseline.json]
+                [--tolerance 0.25] [--mintime 0.2] [--mesh cube.vol]
+                [--interleave]
+
+  A case fails if its median time exceeds the baseline time by more than
+  the relative tolerance, then the exit code is 1. A baseline case of the
+  selected sizes, threads and filter which did not run (it threw, or it
+  does not exist anymore) fails as well. New cases not in the baseline
+  are reported, but don't fail.
+
+  --interleave allocates vectors interleaved over the NUMA nodes instead
+  of first touch by the threads (compare SpMVBandwidth on multi-socket
+  nodes, with one thread and all threads).
+
+  Started with mpirun (MPI build), the mesh is distributed over the ranks
+  and VectorOpsDistributed times ParallelVector operations; the other
+  cases run on the local parts. Rank 0 reports, writes the results and
+  compares with the baseline, which should come from a run with the same
+  number of ranks.
+*/
+
+#include "benchmark.hpp"
+#include <fstream>
+#include <regex>
+
+using namespace ngs_benchmark;
+
+static Array<string> SplitList (const string & str, char sep = ',')
+{
+  Array<string> res;
+  stringstream ss(str);
+  string item;
+  while (getline(ss, item, sep))
+    if (item.size()) res.Append(item);
+  return res;
+}
+
+static Result RunCase (const BenchmarkCase & bc, const Setup & setup, const ProblemSize & ps,
+                       int threads, double mintime)
+{
+  Array<double> times;
+  // warm up, and first measurement
+  double total = 0;
+  while (times.Size() < 3 || (total < mintime && times.Size() < 100))
+    {
+      double start = WallTime();
+      setup.kernel();
+      double t = WallTime()-start;
+      times.Append (t);
+      total += t;
+    }
+  times.DeleteElement(0);   // warm-up run
+  QuickSort (times);
+
+  return Result { bc.name, ps.name, threads,
+                  times[times.Size()/2], times[0], int(times.Size()),
+                  setup.work, setup.work_unit };
+}
+
+static void WriteResults (const string & filename, FlatArray<Result> results)
+{
+  ofstream out(filename);
+  out.precision(8);
+  out << "{\n\"build\": {\"compiler\": \"" <<
+#if defined(__clang__)
+    "clang-" << __clang_version__
+#elif defined(__GNUC__)
+    "gcc-" << __VERSION__
+#elif defined(_MSC_VER)
+    "msvc-" << _MSC_VER
+#else
+    "unknown"
+#endif
+      << "\", \"maxthreads\": " << TaskManager::GetMaxThreads()
+      << ", \"numa_interleave\": " << (numa_interleave ? "true" : "false") << "},\n";
+  out << "\"results\": [\n";
+  for (size_t i = 0; i < results.Size(); i++)
+    {
+      auto & r = results[i];
+      // one result per line, parsed by ReadBaseline
+      out << "{\"name\": \"" << r.name << "\", \"size\": \"" << r.size << "\", \"threads\": " << r.threads
+          << ", \"time\": " << r.time << ", \"mintime\": " << r.mintime << ", \"runs\": " << r.runs;
+      if (r.work > 0)
+        out << ", \"work\": " << r.work << ", \"unit\": \"" << r.work_unit << "\""
+            << ", \"rate\": " << r.work / r.time;
+      out << "}" << (i+1 < results.Size() ? "," : "") << "\n";
+    }
+  out << "]\n}\n";
+}
+
+static map<string,double> ReadBaseline (const string & filename)
+{
+  ifstream in(filename);
+  if (!in)
+    throw Exception ("cannot open baseline file " + filename);
+
+  regex re(R"(\"name\": \"([^\"]*)\", \"size\": \"([^\"]*)\", \"threads\": (\d+), \"time\": ([0-9.eE+-]+))");
+  map<string,double> baseline;
+  string line;
+  smatch match;
+  while (getline(in, line))
+    if (regex_search(line, match, re))
+      baseline[match[1].str() + "/" + match[2].str() + "/" + match[3].str()] = stod(match[4].str());
+  return baseline;
+}
+
+
+int main (int argc, char ** argv)
+{
+  NgMPI_Comm comm;
+#ifdef PARALLEL
+  static MyMPI mympi(argc, argv);
+  comm = NgMPI_Comm(MPI_COMM_WORLD);
+#endif
+  bool master = comm.Rank() == 0;
+  // only rank 0 reports
+  if (!master)
+    cout.setstate (ios_base::badbit);
+  netgen::printmessage_importance = 0;
+
+  Array<ProblemSize> all_sizes {
+    { "small", 2, 2 },
+    { "medium", 3, 3 },
+    { "large", 4, 4 } };
+
+  string sizes = "small,medium";
+  string threadlist = "1," + ToString(TaskManager::GetMaxThreads());
+  string filter, baselinefile, meshfile = "cube.vol";
+  string outputfile = "benchmark_results.json";
+  double tolerance = 0.25, mintime = 0.2;
+
+  for (int i = 1; i < argc; i++)
+    {
+      string arg = argv[i];
+      auto Next = [&] () -> string
+        {
+          if (i+1 >= argc) throw Exception ("missing value for " + arg);
+          return argv[++i];
+        };
+      if (arg == "--sizes") sizes = Next();
+      else if (arg == "--threads") threadlist = Next();
+      else if (arg == "--filter") filter = Next();
+      else if (arg == "--output") outputfile = Next();
+      else if (arg == "--baseline") baselinefile = Next();
+      else if (arg == "--tolerance") tolerance = stod(Next());
+      else if (arg == "--mintime") mintime = stod(Next());
+      else if (arg == "--mesh") meshfile = Next();
+      else if (arg == "--interleave") numa_interleave = true;
+      else
+        {
+          cerr << "unknown argument " << arg << endl;
+          return 2;
+        }
+    }
+
+  Array<int> nthreads;
+  for (auto t : SplitList(threadlist))
+    if (!nthreads.Contains(stoi(t)))
+      nthreads.Append (stoi(t));
+
+  Array<Result> results;
+  Array<string> errors;
+  for (auto sizename : SplitList(sizes))
+    {
+      int sizenr = -1;
+      for (int j = 0; j < all_sizes.Size(); j++)
+        if (all_sizes[j].name == sizename) sizenr = j;
+      if (sizenr == -1)
+        throw Exception ("unknown problem size " + sizename);
+      auto & ps = all_sizes[sizenr];
+
+      auto ma = comm.Size() > 1 ? make_shared<MeshAccess> (meshfile, comm) : make_shared<MeshAccess> (meshfile);
+      for (int j = 0; j < ps.refinements; j++)
+        ma->Refine(false);
+      cout << "size " << ps.name << ": " << ma->GetNE(VOL) << " elements, order " << ps.order << endl;
+
+      for (auto & bc : GetBenchmarkCases())
+        {
+          if (sizenr >= bc.maxsize) continue;
+          if (filter.size() && bc.name.find(filter) == string::npos) continue;
+
+          for (int nt : nthreads)
+            {
+              TaskManager::SetNumThreads (nt);
+              LocalHeap lh(100*1000*1000, "benchmark");
+              RunWithTaskManager ([&] ()
+                {
+                  try
+                    {
+                      Setup setup = bc.setup (ma, ps, lh);
+                      auto res = RunCase (bc, setup, ps, nt, mintime);
+                      cout << "  " << setw(20) << left << bc.name << right << " threads = " << setw(3) << nt
+                           << "  time = " << setw(12) << res.time << " s";
+                      if (res.work > 0)
+                        cout << "  " << res.work/res.time << " " << res.work_unit << "/s";
+                      cout << endl;
+                      results.Append (res);
+                    }
+                  catch (const Exception & e)
+                    {
+                      cout << "  " << bc.name << " threads = " << nt << "  failed: " << e.What() << endl;
+                      errors.Append (bc.name + "/" + ps.name + "/" + ToString(nt));
+                    }
+                });
+            }
+        }
+    }
+
+  if (!master)
+    return 0;
+
+  WriteResults (outputfile, results);
+  cout << "results written to " << outputfile << endl;
+
+  if (baselinefile.empty())
+    return 0;
+
+  auto baseline = ReadBaseline (baselinefile);
+  int failed = 0;
+
+  // baseline cases of this selection without a result
+  auto sizelist = SplitList(sizes);
+  for (auto & [key, time] : baseline)
+    {
+      auto parts = SplitList (key, '/');
+      if (parts.Size() != 3) continue;
+      if (!sizelist.Contains(parts[1]) || !nthreads.Contains(stoi(parts[2]))) continue;
+      if (filter.size() && parts[0].find(filter) == string::npos) continue;
+
+      bool found = false;
+      for (auto & r : results)
+        if (r.Key() == key) found = true;
+      if (found) continue;
+      failed++;
+      cout << (errors.Contains(key) ? "ERROR      " : "MISSING    ")
+           << setw(40) << left << key << right << "  " << time << " s" << endl;
+    }
+
+  for (auto & r : results)
+    {
+      auto it = baseline.find(r.Key());
+      if (it == baseline.end())
+        {
+          cout << "new:       " << r.Key() << endl;
+          continue;
+        }
+      double ratio = r.time / it->second;
+      bool fail = ratio > 1+tolerance;
+      if (fail) failed++;
+      cout << (fail ? "REGRESSION " : (ratio < 1-tolerance ? "faster     " : "ok         "))
+           << setw(40) << left << r.Key() << right
+           << "  " << it->second << " s -> " << r.time << " s  (x" << ratio << ")" << endl;
+    }
+  cout << failed << " failures (tolerance " << tolerance << ")" << endl;
+  return failed ? 1 : 0;
+}
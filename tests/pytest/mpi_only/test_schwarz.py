@@ -0,0 +1,23 @@
+from ngsolve import *
+from ngsolve.krylovspace import CGSolver, GMResSolver
+
+def test_schwarz():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=4, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    f = LinearForm(2*(y*(1-y)+x*(1-x))*v*dx)
+    pres = [Preconditioner(a, "schwarz"),
+            Preconditioner(a, "schwarz", restricted=True),
+            Preconditioner(a, "schwarz", coarse=False)]
+    a.Assemble()
+    f.Assemble()
+
+    exact = x*(1-x)*y*(1-y)
+    gfu = GridFunction(fes)
+    for pre, solver in zip(pres, [CGSolver, GMResSolver, CGSolver]):
+        inv = solver(mat=a.mat, pre=pre, tol=1e-12, maxiter=200)
+        gfu.vec.data = inv * f.vec
+        assert inv.iterations < 100
+        assert sqrt(Integrate((gfu-exact)**2, mesh)) < 1e-8
@@ -2,6 +2,7 @@
 from netgen import meshing
 from netgen.csg import Pnt
 from ngsolve import *
+import pytest
     
 def test_convection1d_dg():
     m = meshing.Mesh()
@@ -53,3 +54,66 @@ def test_convection1d_dg():
     l2error = sqrt(Integrate((u-u0)*(u-u0),mesh))
     print(l2error)
     assert l2error < 1e-2
+
+
+def periodic_mesh(nel):
+    m = meshing.Mesh()
+    m.dim = 1
+    pnums = []
+    for i in range(0, nel+1):
+        pnums.append (m.Add (meshing.MeshPoint (Pnt(i/nel, 0, 0))))
+    for i in range(0,nel):
+        m.Add (meshing.Element1D ([pnums[i],pnums[i+1]], index=1))
+    m.Add (meshing.Element0D (pnums[0], index=1))
+    m.Add (meshing.Element0D (pnums[nel], index=2))
+    m.AddPointIdentification(pnums[0],pnums[nel],identnr=1,type=meshing.IdentificationType.PERIODIC)
+    return Mesh (m)
+
+
+def test_explicit_timestepper():
+    mesh = periodic_mesh(20)
+    fes = L2(mesh, order=4)
+    u,v = fes.TnT()
+    b = CoefficientFunction(1)
+    bn = b*specialcf.normal(1)
+    a = BilinearForm(fes, nonassemble=True)
+    a += -u * b*grad(v) * dx
+    a += bn*IfPos(bn, u, u.Other()) * v * dx(element_boundary=True)
+
+    u0 = exp (-100 * (x-0.5)*(x-0.5) )
+    gfu = GridFunction(fes)
+
+    # same as a hand written SSP-RK3 loop
+    gfu.Set(u0)
+    ref = gfu.vec.CreateVector()
+    ref.data = gfu.vec
+    u1 = ref.CreateVector()
+    w = ref.CreateVector()
+    def L(vec):
+        a.Apply(vec, w)
+        fes.SolveM(rho=CoefficientFunction(1), vec=w)
+        return -w
+    tau = 1e-3
+    for i in range(10):
+        u1.data = ref + tau * L(ref)
+        u1.data = 0.75 * ref + 0.25 * (u1 + tau * L(u1))
+        ref.data = 1/3 * ref + 2/3 * (u1 + tau * L(u1))
+
+    stepper = ExplicitTimeStepper(fes, a, scheme="ssprk3")
+    assert stepper.diagonal_mass
+    t = stepper.Run(gfu, 0, tau, 10)
+    assert abs(t - 10*tau) < 1e-12
+    ref -= gfu.vec
+    assert Norm(ref) < 1e-10 * Norm(gfu.vec)
+
+    # one period with the low-storage 4th order scheme
+    gfu.Set(u0)
+    with TaskManager():
+        ExplicitTimeStepper(fes, a, scheme="lsrk45").Run(gfu, 0, tau, 1000)
+    l2error = sqrt(Integrate((gfu-u0)*(gfu-u0),mesh))
+    assert l2error < 1e-2
+
+    # the inverse mass of an H1 component is not available
+    fesh1 = fes*H1(mesh, order=2)
+    with pytest.raises(Exception, match="L2"):
+        ExplicitTimeStepper(fesh1, BilinearForm(fesh1, nonassemble=True))
@@ -17,3 +17,17 @@ def test_dual_hcurl(element):
     a.Assemble()
     dense = sps.csr_matrix(a.mat.CSR()).todense()
     assert dense == pytest.approx(np.identity(a.mat.height)), "mat = " + str(dense)
+
+
+@pytest.mark.parametrize("element", [Trig, Quad, Tet])
+def test_convertoperator_geom_free(element):
+    mesh = Mesh(element())
+    mesh.Refine()
+    fesa = H1(mesh, order=3)
+    fesb = H1(mesh, order=2)
+    ebe = ConvertOperator(fesa, fesb, geom_free=True)
+    spm = ConvertOperator(fesa, fesb)
+    x = ebe.CreateRowVector()
+    x.SetRandom()
+    diff = (ebe*x - spm*x).Evaluate()
+    assert Norm(diff) < 1e-10 * Norm(x)
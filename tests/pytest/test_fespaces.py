@@ -99,6 +99,80 @@ def test_SurfaceGetFE(quads=False):
                         assert space.GetFE(el).ndof == len(space.GetDofNrs(el)), [spacename,vb,order]
     return
 
+
+def test_parallel_coloring_assembly():
+    # element and facet coloring are computed in parallel, the assembled
+    # matrices must not depend on the number of threads
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.2))
+
+    def Apply():
+        fes = L2(mesh, order=2, dgjumps=True)
+        u,v = fes.TnT()
+        n = specialcf.normal(3)
+        jump = lambda w : w-w.Other()
+        a = BilinearForm(grad(u)*grad(v)*dx + 10*jump(u)*jump(v)*dx(skeleton=True)
+                         - n*grad(u)*jump(v)*dx(skeleton=True)).Assemble()
+        gf = GridFunction(fes)
+        gf.Set(1+x*y-z)
+        res = gf.vec.CreateVector()
+        res.data = a.mat * gf.vec
+        return res
+
+    ref = Apply()
+    with TaskManager():
+        res = Apply()
+    res -= ref
+    assert Norm(res) < 1e-10 * Norm(ref)
+
+
+def test_dg_apply_facet_neighbours():
+    # matrix-free DG apply uses the cached facet neighbours
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=True))
+    fes = L2(mesh, order=3, dgjumps=True)
+    u,v = fes.TnT()
+    n = specialcf.normal(2)
+    jump = lambda w : w-w.Other()
+    mean = lambda w : 0.5*(w+w.Other())
+    form = grad(u)*grad(v)*dx + 10*jump(u)*jump(v)*dx(skeleton=True) \
+        - n*mean(grad(u))*jump(v)*dx(skeleton=True) \
+        + 10*u*v*ds(skeleton=True)
+    a = BilinearForm(form).Assemble()
+    b = BilinearForm(form, nonassemble=True)
+    gf = GridFunction(fes)
+    gf.Set(1+x*y-y*y)
+    ref = gf.vec.CreateVector()
+    res = gf.vec.CreateVector()
+    ref.data = a.mat * gf.vec
+    with TaskManager():
+        b.Apply(gf.vec, res)
+    res -= ref
+    assert Norm(res) < 1e-10 * Norm(ref)
+
+
+def test_dg_apply_facet_batches():
+    # interior facets of equal element classes are applied in batches
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = L2(mesh, order=2, dgjumps=True)
+    u,v = fes.TnT()
+    n = specialcf.normal(3)
+    b = CoefficientFunction((1+y, z-x, 0.5))
+    bn = b*n
+    upwind = IfPos(bn, u, u.Other())
+    form = -u*b*grad(v)*dx + bn*upwind*(v-v.Other())*dx(skeleton=True) \
+        + (1+x)*(u-u.Other())*(v-v.Other())*dx(skeleton=True)
+    a = BilinearForm(form).Assemble()
+    c = BilinearForm(form, nonassemble=True)
+    gf = GridFunction(fes)
+    gf.Set(x*y+z*z)
+    ref = gf.vec.CreateVector()
+    res = gf.vec.CreateVector()
+    ref.data = a.mat * gf.vec
+    with TaskManager():
+        c.Apply(gf.vec, res)
+    res -= ref
+    assert Norm(res) < 1e-10 * Norm(ref)
+
+
 if __name__ == "__main__":
     test_2DGetFE(quads=False)
     test_2DGetFE(quads=True)
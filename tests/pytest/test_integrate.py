@@ -25,3 +25,23 @@ def test_integrate_xy():
     intC = Integrate(1j*x*y,mesh)
     assert abs(intR-1./4) < 1e-14
     assert abs(intC- 1j*1./4) < 1e-14
+
+def test_cfintegrator():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    gfu = GridFunction(fes)
+    integrator = CFIntegrator([gfu, x*y, CoefficientFunction((x,y))], mesh, order=4)
+    assert integrator.dim == 4
+    for t in range(3):
+        gfu.Set(t*x)
+        with TaskManager():
+            iu, ixy, ivec = integrator()
+        assert abs(iu - t/2) < 1e-12
+        assert abs(ixy - 1./4) < 1e-14
+        assert abs(ivec[0] - 0.5) < 1e-14 and abs(ivec[1] - 0.5) < 1e-14
+
+    bnd = CFIntegrator(x, mesh.Boundaries("top"), order=2)
+    assert abs(bnd() - 0.5) < 1e-14
+
+    sums, elvals = CFIntegrator(x*y, mesh, order=4)(element_wise=True)
+    assert abs(sum(elvals.NumPy()[:,0]) - sums) < 1e-14
@@ -84,6 +84,85 @@ def test_SymDevMatrixValuedL2(mesh2d):
     _test_interpolation(space, _expr(x, y), _check)
 
 
+def test_highorder_l2_tabulated_shapes(mesh2d):
+    # from order 5 on, L2 elements evaluate via tabulated SIMD shapes
+    mesh = mesh2d
+    fes = L2(mesh, order=6)
+    gf = GridFunction(fes)
+    expr = x**5*y + y**6
+    gf.Set(expr)
+    assert Integrate((gf-expr)**2, mesh) < 1e-20
+    gradexpr = CoefficientFunction((5*x**4*y, x**5+6*y**5))
+    assert Integrate(InnerProduct(grad(gf)-gradexpr, grad(gf)-gradexpr), mesh) < 1e-16
+
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += (grad(u)*grad(v) + u*v)*dx
+    a.Assemble()
+    y1 = gf.vec.CreateVector()
+    y2 = gf.vec.CreateVector()
+    a.Apply(gf.vec, y1)
+    y2.data = a.mat * gf.vec
+    y1.data -= y2
+    assert Norm(y1) < 1e-10 * Norm(y2)
+
+
+def test_highorder_l2_tabulated_matrix(mesh2d):
+    # SIMD assembly takes the tabulated shapes, simd_evaluate=False computes them directly
+    fes = L2(mesh2d, order=6)
+    u,v = fes.TnT()
+    form = grad(u)*grad(v) + u*v
+    a = BilinearForm(fes)
+    a += form*dx
+    a.Assemble()
+    aref = BilinearForm(fes)
+    aref += SymbolicBFI(form, simd_evaluate=False)
+    aref.Assemble()
+    diff = a.mat.AsVector().CreateVector()
+    diff.data = a.mat.AsVector() - aref.mat.AsVector()
+    assert Norm(diff) < 1e-10 * Norm(aref.mat.AsVector())
+
+
+def test_setvalues_interpolator(mesh2d):
+    mesh = mesh2d
+    t = Parameter(0)
+    cf = sin(x + t) * (1 + y * y)
+
+    def compare(space, cf, **kwargs):
+        gf_ref = GridFunction(space)
+        gf = GridFunction(space)
+        interp = SetValuesInterpolator(space, **kwargs)
+        for tval in [0, 0.3, 1.7]:
+            t.Set(tval)
+            gf_ref.Set(cf, **kwargs)
+            interp.Set(cf, gf)
+            gf.vec.data -= gf_ref.vec
+            assert Norm(gf.vec) < 1e-12 * (1 + Norm(gf_ref.vec))
+
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    compare(fes, cf)
+    compare(fes, cf, VOL_or_BND=BND)
+    compare(fes, cf, VOL_or_BND=BND, definedon=mesh.Boundaries("top"))
+    compare(fes, cf, dual=True)
+    compare(VectorH1(mesh, order=2), CoefficientFunction((cf, x * cf)))
+
+
+def test_setvalues_interpolator_refine():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.5))
+    cf = sin(x) * (1 + y * y)
+    fes = H1(mesh, order=2, dirichlet="left|bottom", autoupdate=True)
+    gf_ref = GridFunction(fes, autoupdate=True)
+    gf = GridFunction(fes, autoupdate=True)
+    interp = SetValuesInterpolator(fes, VOL_or_BND=BND)
+    interp.Set(cf, gf)
+
+    mesh.Refine()
+    gf_ref.Set(cf, BND)
+    interp.Set(cf, gf)
+    gf.vec.data -= gf_ref.vec
+    assert Norm(gf.vec) < 1e-12 * (1 + Norm(gf_ref.vec))
+
+
 if __name__ == "__main__":
     mesh = mk_2d_mesh()
     test_MatrixValuedL2(mesh)
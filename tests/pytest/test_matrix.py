@@ -99,7 +99,63 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sparsematrix_matmult_reuse():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    b = BilinearForm(fes)
+    b += u*v*dx
+    b.Assemble()
+
+    prod = a.mat.MatMultSymbolic(b.mat)
+    a.mat.MatMultNumeric(b.mat, prod)
+    ref = a.mat @ b.mat
+
+    x = a.mat.CreateColVector()
+    x.SetRandom()
+    z = x.CreateVector()
+    z.data = ref * x
+    y = x.CreateVector()
+    y.data = prod * x - z
+    assert Norm(y) < 1e-12 * Norm(z)
+
+    # new values, same graph
+    a.mat.AsVector().data *= 2
+    a.mat.MatMultNumeric(b.mat, prod)
+    y.data = prod * x - 2 * z
+    assert Norm(y) < 1e-12 * Norm(z)
+
+def test_symmetric_sparsematrix_mult():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    asym = BilinearForm(fes, symmetric=True)
+    asym += (grad(u)*grad(v)+u*v)*dx
+    anonsym = BilinearForm(fes, symmetric=False)
+    anonsym += (grad(u)*grad(v)+u*v)*dx
+
+    vecs = MultiVector(fes.ndof, 3, False)
+    for i in range(3):
+        vecs[i].SetRandom()
+    y = MultiVector(fes.ndof, 3, False)
+    yref = vecs[0].CreateVector()
+
+    with TaskManager():
+        asym.Assemble()
+        anonsym.Assemble()
+        y[:] = asym.mat * vecs
+        for i in range(3):
+            yref.data = anonsym.mat * vecs[i]
+            assert Norm(yref - y[i]) < 1e-10 * Norm(yref)
+            yref.data -= asym.mat * vecs[i]
+            assert Norm(yref) < 1e-10 * Norm(y[i])
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sparsematrix_matmult_reuse()
+    test_symmetric_sparsematrix_mult()
@@ -82,6 +82,57 @@ def test_neighbours2d():
     assert mesh.Materials("base").Boundaries() * mesh.Materials("top").Boundaries() == mesh.Boundaries("default")
     assert mesh.Materials("base").Boundaries() * mesh.Materials("chip").Boundaries() == mesh.Boundaries("")
 
+def test_geometry_cache():
+    geo = SplineGeometry()
+    geo.AddCircle((0,0), 1, bc="circle")
+    mesh = Mesh(geo.GenerateMesh(maxh=0.3))
+    mesh.Curve(4)
+
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx + u*v*ds
+    a.Assemble()
+    ref = a.mat.AsVector().FV().NumPy().copy()
+    area = Integrate(1, mesh)
+
+    mesh.EnableGeometryCache()
+    for i in range(2):
+        a.Assemble()
+        assert max(abs(a.mat.AsVector().FV().NumPy() - ref)) < 1e-12
+        assert abs(Integrate(1, mesh) - area) < 1e-12
+    assert mesh.geometry_cache_memory > 0
+
+    # curving again invalidates the cache
+    mesh.Curve(1)
+    area1 = Integrate(1, mesh)
+    assert abs(area1 - area) > 1e-6
+    mesh.DisableGeometryCache()
+    assert abs(Integrate(1, mesh) - area1) < 1e-12
+
+def test_adaptive_refine_reuse_elmats():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, autoupdate=True)
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*ds, reuse_elmats=True)
+    aref = BilinearForm(grad(u)*grad(v)*dx + u*v*ds)
+    gfu = GridFunction(H1(mesh, order=1, autoupdate=True), autoupdate=True)
+    gfu.Set(x+2*y)
+
+    for l in range(4):
+        if l > 0:
+            # refine the elements in the lower left corner only
+            for el in mesh.Elements():
+                mesh.SetRefinementFlag(el, max(mesh[vi].point[0]+mesh[vi].point[1] for vi in el.vertices) < 0.5**l)
+            mesh.Refine()
+        a.Assemble()
+        aref.Assemble()
+        diff = (a.mat.AsVector() - aref.mat.AsVector()).Evaluate()
+        assert Norm(diff) < 1e-12 * Norm(aref.mat.AsVector())
+        # prolongation is exact for linear functions
+        assert Integrate((gfu-(x+2*y))**2, mesh) < 1e-24
+    assert sum(m[1] for m in a.__memory__ if "element matrix cache" in m[0]) > 0
+
 if __name__ == "__main__":
     test_neighbours2d()
     test_neighbours()
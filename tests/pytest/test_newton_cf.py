@@ -458,6 +458,26 @@ def test_compound_advanced_nonlinear_symmetric(fes_ir):
     assert np.allclose(1 / 2 * (_res + _res.T), 0)
 
 
+def test_simd_newton_and_minimization():
+    # Integrate evaluates with SIMD integration rules
+    from netgen.geom2d import unit_square
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    f = 1 + x * x + y
+
+    du = H1(mesh, order=1).TrialFunction()
+    ncf = NewtonCF(du ** 2 - f, CoefficientFunction(1), tol=1e-12)
+    assert abs(Integrate(ncf, mesh, order=5) - Integrate(sqrt(f), mesh, order=5)) < 1e-10
+
+    mcf = MinimizationCF(du ** 4 / 4 - f * du, CoefficientFunction(1), tol=1e-12)
+    assert abs(Integrate(mcf, mesh, order=5) - Integrate(f ** (1 / 3), mesh, order=5)) < 1e-10
+
+    dv = VectorH1(mesh, order=1).TrialFunction()
+    eq = CoefficientFunction((dv[0] ** 2 + dv[1] - f, dv[1] - x))
+    ncf = NewtonCF(eq, CoefficientFunction((1, 0)), tol=1e-12)
+    assert abs(Integrate(InnerProduct(ncf, ncf), mesh, order=5)
+               - Integrate(f - x + x * x, mesh, order=5)) < 1e-10
+
+
 if __name__ == "__main__":
     _fes_ir = mk_fes_ir()
     test_scalar_linear_minimization(_fes_ir)
@@ -468,3 +488,4 @@ if __name__ == "__main__":
     test_linear_symmetric_space_non_symmetric_system(_fes_ir)
     test_compound_advanced_linear_nonsymmetric_system(_fes_ir)
     test_compound_advanced_nonlinear_symmetric(_fes_ir)
+    test_simd_newton_and_minimization()
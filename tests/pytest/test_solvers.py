@@ -2,6 +2,7 @@ from netgen.geom2d import unit_square
 from ngsolve import *
 import pytest
 from ngsolve.krylovspace import *
+from ngsolve.la import BlockCG, KrylovSchur
 
 def test_arnoldi():
     SetHeapSize (10*1000*1000)
@@ -55,6 +56,64 @@ def test_newton_with_dirichlet():
     newton = solvers.Newton(a, gfu, dirichletvalues=dirichlet.vec)
 
 
+def test_blockcg():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    pre = Preconditioner(a, "local")
+    a.Assemble()
+
+    gfu = GridFunction(fes)
+    rhs = MultiVector(gfu.vec, 6)
+    for i in range(6):
+        f = LinearForm(fes)
+        f += (x**i + y) * v * dx
+        f.Assemble()
+        rhs[i] = f.vec
+    # linearly dependent right hand sides must not break down
+    rhs[5] = 2*rhs[4]
+
+    sol = MultiVector(gfu.vec, 6)
+    steps = BlockCG(a.mat, pre.mat, rhs, sol, tol=1e-10, maxsteps=500)
+    assert steps < 500
+
+    inv = a.mat.Inverse(fes.FreeDofs())
+    for i in range(6):
+        gfu.vec.data = inv * rhs[i] - sol[i]
+        assert Norm(gfu.vec) < 1e-6 * Norm(sol[i])
+
+def test_krylovschur():
+    from math import pi
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=4, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    m = BilinearForm(u*v*dx).Assemble()
+
+    shift = 10
+    mshift = a.mat.CreateMatrix()
+    mshift.AsVector().data = a.mat.AsVector() - shift * m.mat.AsVector()
+    inv = mshift.Inverse(fes.FreeDofs())
+
+    proj = Projector(fes.FreeDofs(), True)
+    gfu = GridFunction(fes)
+    start = MultiVector(gfu.vec, 3)
+    for i in range(3):
+        gfu.vec.SetRandom()
+        start[i] = (proj * gfu.vec).Evaluate()
+
+    lam, evecs = KrylovSchur(m.mat, inv, shift, start, nev=6, tol=1e-10)
+    exact = [2, 5, 5, 8, 10, 10]
+    for l,e in zip(lam, exact):
+        assert abs(l - e*pi**2) < 1e-4 * e*pi**2
+
+    tmp = gfu.vec.CreateVector()
+    for i in range(6):
+        tmp.data = a.mat * evecs[i] - lam[i] * m.mat * evecs[i]
+        assert Norm((proj * tmp).Evaluate()) < 1e-5 * lam[i] * Norm(evecs[i])
+
 def test_krylovspace_solvers():
     solvers = [CGSolver, GMResSolver, MinResSolver] # , QMRSolver]
     mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
@@ -77,6 +136,98 @@ def test_krylovspace_solvers():
         assert error < 1e-12
 
 
+def test_multigrid_matrixprolongation():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=1, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    f = LinearForm(v*dx)
+    pre_inline = Preconditioner(a, "multigrid")
+    pre_matrix = Preconditioner(a, "multigrid", matrixprolongation=True)
+    for l in range(3):
+        if l > 0:
+            mesh.Refine()
+        fes.Update()
+        a.Assemble()
+        f.Assemble()
+    w1 = (pre_inline * f.vec).Evaluate()
+    w2 = (pre_matrix * f.vec).Evaluate()
+    w1 -= w2
+    assert Norm(w1) < 1e-10 * Norm(w2)
+
+def test_multigrid_chebyshev_smoother():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=1, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    f = LinearForm(v*dx)
+    pre = Preconditioner(a, "multigrid", smoother="chebyshev", chebyshevdegree=2)
+    for l in range(4):
+        if l > 0:
+            mesh.Refine()
+        fes.Update()
+        a.Assemble()
+        f.Assemble()
+    inv = CGSolver(mat=a.mat, pre=pre, tol=1e-10, maxiter=100)
+    gfu = GridFunction(fes)
+    gfu.vec.data = inv * f.vec
+    assert inv.iterations < 30
+
+
+def test_pmultigrid():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=6, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    f = LinearForm(v*dx)
+    for opts in [dict(), dict(smoothers=["block", "gs"], coarsetype="h1amg")]:
+        a = BilinearForm(grad(u)*grad(v)*dx)
+        pre = Preconditioner(a, "pmultigrid", **opts)
+        a.Assemble()
+        f.Assemble()
+        inv = CGSolver(mat=a.mat, pre=pre, tol=1e-10, maxiter=200)
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        exact = (a.mat.Inverse(fes.FreeDofs()) * f.vec).Evaluate()
+        exact -= gfu.vec
+        assert Norm(exact) < 1e-6 * Norm(gfu.vec)
+        assert inv.iterations < 60
+
+
+def test_schwarz_sequential():
+    # a single subdomain is the direct solver
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    pre = Preconditioner(a, "schwarz")
+    a.Assemble()
+    f = LinearForm(v*dx).Assemble()
+    inv = CGSolver(mat=a.mat, pre=pre, tol=1e-10, maxiter=10)
+    gfu = GridFunction(fes)
+    gfu.vec.data = inv * f.vec
+    assert inv.iterations <= 2
+
+
+def test_condense_single_precision():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=5, dirichlet=".*")
+    u,v = fes.TnT()
+    f = LinearForm(v*dx).Assemble()
+    sols = []
+    mems = []
+    for single in [False, True]:
+        a = BilinearForm(grad(u)*grad(v)*dx, condense=True, condense_single=single).Assemble()
+        gfu = GridFunction(fes)
+        fmod = (f.vec + a.harmonic_extension_trans * f.vec).Evaluate()
+        gfu.vec.data = a.mat.Inverse(fes.FreeDofs(True)) * fmod
+        gfu.vec.data += a.harmonic_extension * gfu.vec
+        gfu.vec.data += a.inner_solve * f.vec
+        sols.append(gfu.vec)
+        mems.append(sum(m[1] for m in a.__memory__ if "condensation" in m[0]))
+    diff = (sols[0]-sols[1]).Evaluate()
+    assert Norm(diff) < 1e-5 * Norm(sols[0])
+    assert mems[1] < 0.75 * mems[0]
+
 
 if __name__ == "__main__":
     # test_arnoldi()
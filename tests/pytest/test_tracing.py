@@ -0,0 +1,24 @@
+import json
+from ngsolve import *
+from ngsolve.ngstd import EnableTracing, DisableTracing, WriteChromeTrace
+from netgen.geom2d import unit_square
+
+def test_chrome_trace(tmp_path):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    with TaskManager():
+        EnableTracing()
+        a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+        f = LinearForm(v*dx).Assemble()
+        w = a.mat.CreateColVector()
+        w.data = a.mat * f.vec
+        DisableTracing()
+
+    filename = str(tmp_path / "ngs.trace.json")
+    WriteChromeTrace(filename)
+    with open(filename) as file:
+        trace = json.load(file)
+    names = set(ev["name"] for ev in trace["traceEvents"] if ev["ph"] == "X")
+    assert "IterateElements - color" in names
+    assert "SparseMatrix::MultAdd - part" in names
@@ -40,3 +40,56 @@ def test_vector_numpy():
     assert d[0] == c[0]
     d[1] = 1+3j
     assert d[1] == c[1]
+
+def test_basevector_numpy_views():
+    try:
+        import numpy as np
+    except:
+        pytest.skip("could not import numpy")
+    from ngsolve.la import BaseVector, MultiVector
+    import gc
+
+    v = BaseVector(10)
+    v[:] = 1
+    a = v.NumPy()
+    a[3] = 5
+    assert v[3] == 5
+    del v
+    gc.collect()
+    assert a[3] == 5 and a[0] == 1
+
+    arr = np.arange(8, dtype=float)
+    w = BaseVector.FromNumPy(arr)
+    w *= 2
+    assert arr[7] == 14
+    with pytest.raises(Exception):
+        BaseVector.FromNumPy(arr[::2])
+
+    mv = MultiVector(6, 3, False, contiguous=True)
+    for i in range(3):
+        mv[i][:] = i
+    m = mv.NumPy()
+    assert m.shape == (3, 6)
+    assert np.all(m[2] == 2)
+    m[1, 4] = 7
+    assert mv[1][4] == 7
+
+    marr = np.zeros((4, 5), dtype=complex)
+    mv2 = MultiVector.FromNumPy(marr)
+    mv2[2][:] = 1j
+    assert np.all(marr[2] == 1j)
+    assert np.shares_memory(mv2.NumPy(), marr)
+
+def test_sparsematrix_csr_view():
+    try:
+        import numpy as np
+    except:
+        pytest.skip("could not import numpy")
+    from ngsolve.la import SparseMatrixd
+    mat = SparseMatrixd.CreateFromCOO([0,1,1], [0,0,1], [1.0,2.0,3.0], 2, 2)
+    vals, colind, first = mat.CSR()
+    vals[:] *= 2
+    vals2, _, _ = mat.CSR()
+    assert np.shares_memory(vals, vals2)
+    assert list(vals2) == [2, 4, 6]
+    assert list(colind) == [0, 0, 1] and list(first) == [0, 1, 3]